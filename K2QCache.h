@@ -0,0 +1,158 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "KICachePolicy.h"
+#include "KCacheMutex.h"
+#include "KIndexList.h"
+
+namespace KArcCache {
+
+	// 完整版 2Q（Johnson & Shasha, VLDB 1994）：新键先进 FIFO 队列 A1in，A1in 内的命中不移动节点
+	// （短时间内的相关访问只算一次）。A1in 超过 Kin 时最旧的条目被逐出，键记入幽灵 FIFO A1out（只有键，没有值）。
+	// A1out 中的键再次写入时直接进入主 LRU 链表 Am。只被访问一次的扫描键在 A1in 里就离开，不会冲掉 Am 中的工作集
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class K2QCache : public KICachePolicy<Key, Value> {
+	public:
+		// inPercent / outPercent：A1in 与 A1out 的长度占容量的百分比，论文建议 25% 与 50%
+		explicit K2QCache(size_t capacity, double inPercent = 25.0, double outPercent = 50.0) :
+			capacity_(capacity),
+			inCapacity_(std::max<size_t>(1, static_cast<size_t>(capacity * inPercent / 100.0))),
+			outCapacity_(std::max<size_t>(1, static_cast<size_t>(capacity * outPercent / 100.0)))
+		{
+			index_.reserve(capacity + outCapacity_);
+			pool_.reserve(capacity + outCapacity_);
+		}
+
+		~K2QCache() override = default;
+
+		// 写入 Am 中的键算一次访问；写入 A1in 中的键只更新值；写入 A1out 中的键直接进 Am
+		void put(Key key, Value value) override {
+			if (capacity_ == 0) return;
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = index_.find(key);
+			if (it != index_.end()) {
+				uint32_t i = it->second;
+				Entry& e = pool_[i];
+				e.value = std::move(value);
+				if (e.state == State::Main) main_.moveToFront(pool_, i);
+				if (e.state != State::Out) return;
+				// 先摘出 A1out，腾位置时的裁剪就不会删掉它
+				out_.remove(pool_, i);
+				e.state = State::Main;
+				makeRoom();
+				main_.pushFront(pool_, i);
+				return;
+			}
+
+			makeRoom();
+			uint32_t i = pool_.allocate();
+			Entry& e = pool_[i];
+			e.key = key;
+			e.value = std::move(value);
+			e.state = State::In;
+			in_.pushFront(pool_, i);
+			index_.emplace(std::move(key), i);
+		}
+
+		bool get(Key key, Value& value) override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = index_.find(key);
+			if (it == index_.end()) return false;
+			uint32_t i = it->second;
+			Entry& e = pool_[i];
+			if (e.state == State::Out) return false; // 没有值，只能等下一次 put
+			value = e.value;
+			if (e.state == State::Main) main_.moveToFront(pool_, i);
+			return true;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		size_t getCapacity() const { return capacity_; }
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			appendLockStats(stats, "2q", mutex_);
+			return stats;
+		}
+
+		// A1out 条目（键 + 节点）计入 ghost；节点池按已分配槽位统计
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			namespace est = memory_estimate;
+			using Node = typename Pool::Node;
+			std::lock_guard<CacheMutex> lk(mutex_);
+			size_t ghosts = out_.size();
+			size_t resident = index_.size() - ghosts;
+			MemoryUsage usage;
+			usage.entries = resident;
+			usage.index = est::hashTable(index_) - ghosts * est::hashNode<Key, uint32_t>();
+			usage.nodes = pool_.slots() * sizeof(Node) - resident * sizeof(Value) - ghosts * sizeof(Node);
+			usage.ghost = ghosts * (sizeof(Node) + est::hashNode<Key, uint32_t>());
+			usage.values = resident * sizeof(Value);
+			usage.exact = static_cast<bool>(valueSize);
+			if (valueSize) {
+				for (auto& kv : index_) {
+					if (pool_[kv.second].state != State::Out) usage.values += valueSize(pool_[kv.second].value);
+				}
+			}
+			return usage;
+		}
+
+	private:
+		enum class State : uint8_t { In, Main, Out };
+
+		struct Entry {
+			Key key{};
+			Value value{};
+			State state = State::In;
+		};
+
+		// 三条链表互斥，共用一组指针
+		using Pool = IndexPool<Entry, 1>;
+
+		// 常驻条目已满时腾出一个位置：A1in 超过 Kin（或 Am 为空）时逐出 A1in 最旧的条目并记入 A1out，否则逐出 Am 最旧的条目
+		void makeRoom()
+		{
+			if (in_.size() + main_.size() < capacity_) return;
+			if (in_.size() > inCapacity_ || (main_.empty() && !in_.empty())) {
+				uint32_t victim = in_.back();
+				in_.remove(pool_, victim);
+				Entry& e = pool_[victim];
+				e.state = State::Out;
+				e.value = Value();
+				out_.pushFront(pool_, victim);
+				while (out_.size() > outCapacity_) {
+					uint32_t oldest = out_.back();
+					out_.remove(pool_, oldest);
+					drop(oldest);
+				}
+				return;
+			}
+			uint32_t victim = main_.back();
+			main_.remove(pool_, victim);
+			drop(victim);
+		}
+
+		void drop(uint32_t i)
+		{
+			index_.erase(pool_[i].key);
+			pool_.release(i);
+		}
+
+		size_t capacity_;
+		size_t inCapacity_;
+		size_t outCapacity_;
+		CacheMutex mutex_;
+		std::unordered_map<Key, uint32_t, Hash, KeyEqual> index_;
+		Pool pool_;
+		IndexList<0> in_;    // A1in，back 最旧
+		IndexList<0> main_;  // Am，back 最旧
+		IndexList<0> out_;   // A1out，back 最旧
+	};
+}
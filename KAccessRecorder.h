@@ -0,0 +1,301 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KArcMaintainer.h"
+#include "KArcSampler.h"
+#include "KInstanceLocal.h"
+#include "KTraceSimulator.h"
+
+namespace KArcCache {
+
+	// 一次被录制的访问。timestamp 为录制开始以来的纳秒数，keyHash 为缓存对键算出的哈希（整数键通常就是键本身），
+	// size 为值的字节数（由调用方给出，未知时为 0），op 为 Get 或 Put，hit 为该次访问是否命中
+	struct AccessRecord {
+		uint64_t timestamp;
+		uint64_t keyHash;
+		uint32_t size;
+		TraceOpType op;
+		bool hit;
+	};
+
+	// 录制 trace 文件：魔数、u32 版本、f64 采样率，之后逐条记录
+	//   u8 标志（低 2 位 op，第 2 位 hit）、varint 时间戳差值（与上一条相比，zigzag 编码）、u64 keyHash、varint size。
+	// 各线程的记录按批写入，时间戳整体只是近似有序，差值因此带符号；同一线程每 16 条记录读一次时钟。数值按小端写入
+	namespace trace_format {
+		constexpr char kMagic[8] = { 'K', 'A', 'R', 'C', 'T', 'R', 'C', 'E' };
+		constexpr uint32_t kVersion = 1;
+
+		inline void putFixed(std::string& out, uint64_t v, size_t bytes)
+		{
+			for (size_t i = 0; i < bytes; ++i) out.push_back(static_cast<char>(v >> (8 * i)));
+		}
+
+		// 写到 p 处，返回写完后的位置
+		inline char* putVarint(char* p, uint64_t v)
+		{
+			while (v >= 0x80) {
+				*p++ = static_cast<char>(v | 0x80);
+				v >>= 7;
+			}
+			*p++ = static_cast<char>(v);
+			return p;
+		}
+
+		inline uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+		inline int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+	}
+
+	// 在线访问录制：每个线程一个无锁的单生产者单消费者环，record 只写本线程的环，满了就丢弃并计数，从不阻塞；
+	// 后台线程（ArcMaintainer）定期或在某个环过半时把各环的记录编码后追加到 trace 文件。
+	// 采样按键的哈希（KeySampler），同一个键的访问要么全部录下、要么全部跳过，采样后的 trace 仍保留重用距离，
+	// 按 SHARDS 的方式在 capacity * rate 的缓存上回放即可估计全量命中率
+	class AccessRecorder {
+	public:
+		// ringSize 向上取整为 2 的幂
+		explicit AccessRecorder(const std::string& path, double sampleRate = 1.0,
+			std::chrono::milliseconds flushInterval = std::chrono::milliseconds(50), size_t ringSize = 16384) :
+			sampler_(sampleRate),
+			ringMask_(roundUpPow2(ringSize) - 1),
+			start_(std::chrono::steady_clock::now()),
+			out_(path, std::ios::binary | std::ios::trunc),
+			lastTimestamp_(0),
+			written_(0),
+			dropped_(0)
+		{
+			std::string header(trace_format::kMagic, sizeof(trace_format::kMagic));
+			trace_format::putFixed(header, trace_format::kVersion, 4);
+			double rate = sampler_.rate();
+			uint64_t bits;
+			std::memcpy(&bits, &rate, sizeof(bits));
+			trace_format::putFixed(header, bits, 8);
+			out_.write(header.data(), static_cast<std::streamsize>(header.size()));
+			flusher_ = std::make_unique<ArcMaintainer>([this] { drain(); return true; }, flushInterval);
+		}
+
+		// 先停后台线程，再把剩余记录写完。仍在运行的线程的表项要等它们下次新建表项或退出时才摘除，
+		// 环的记录数组在这里先释放，表项只剩一个空壳
+		~AccessRecorder()
+		{
+			flusher_.reset();
+			drain();
+			std::lock_guard<std::mutex> registry(registryMutex_);
+			for (auto& ring : rings_) ring->slots.reset();
+		}
+
+		AccessRecorder(const AccessRecorder&) = delete;
+		AccessRecorder& operator=(const AccessRecorder&) = delete;
+
+		bool ok()
+		{
+			std::lock_guard<std::mutex> lock(drainMutex_);
+			return static_cast<bool>(out_);
+		}
+
+		double sampleRate() const { return sampler_.rate(); }
+
+		// 该键是否被采样；调用方可以先判断，未采样的键省去计算值大小等准备工作
+		bool sampled(uint64_t keyHash) const { return sampler_.sampled(mixHash(keyHash)); }
+
+		// 热路径：未被采样的键只多一次哈希混合与比较
+		void record(uint64_t keyHash, TraceOpType op, bool hit, uint32_t size)
+		{
+			if (!sampled(keyHash)) return;
+			Ring& ring = localRing();
+			uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+			if (tail - ring.headCache > ringMask_) {
+				ring.headCache = ring.head.load(std::memory_order_acquire);
+				if (tail - ring.headCache > ringMask_) {
+					ring.dropped.fetch_add(1, std::memory_order_relaxed);
+					flusher_->notify();
+					return;
+				}
+			}
+			// 读时钟比记录本身还贵，每 kClockEvery 条才读一次，其间的记录沿用上一次的时间戳
+			if ((tail & (kClockEvery - 1)) == 0) {
+				ring.now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start_).count());
+			}
+			ring.slots[tail & ringMask_] = AccessRecord{ ring.now, keyHash, size, op, hit };
+			ring.tail.store(tail + 1, std::memory_order_release);
+			// 环过半时叫醒后台线程，避免高峰期只靠定时刷新而丢记录
+			if (((tail + 1) & (ringMask_ >> 1)) == 0) flusher_->notify();
+		}
+
+		// 立即把各环中的记录写入文件并刷新文件缓冲
+		void flush()
+		{
+			drain();
+			std::lock_guard<std::mutex> lock(drainMutex_);
+			out_.flush();
+		}
+
+		// 已写入文件的记录数
+		uint64_t written()
+		{
+			std::lock_guard<std::mutex> lock(drainMutex_);
+			return written_;
+		}
+
+		// 因环满而丢弃的记录数
+		uint64_t dropped()
+		{
+			std::lock_guard<std::mutex> registry(registryMutex_);
+			uint64_t n = dropped_;
+			for (auto& ring : rings_) n += ring->dropped.load(std::memory_order_relaxed);
+			return n;
+		}
+
+	private:
+		// head 由后台线程推进，tail 由所属线程推进，中间补齐一条缓存行使二者分处不同行；headCache 是生产者对 head 的本地副本。
+		// 用填充而非 alignas(64)：C++14 的 make_shared 不保证超对齐
+		struct Ring {
+			explicit Ring(size_t size) : slots(new AccessRecord[size]) {}
+			std::atomic<uint64_t> head{ 0 };
+			char headPad[64 - sizeof(std::atomic<uint64_t>)];
+			std::atomic<uint64_t> tail{ 0 };
+			uint64_t headCache = 0;
+			uint64_t now = 0; // 生产者最近一次读到的时间戳
+			std::atomic<uint64_t> dropped{ 0 };
+			std::unique_ptr<AccessRecord[]> slots;
+		};
+
+		static size_t roundUpPow2(size_t n)
+		{
+			size_t p = 64;
+			while (p < n) p <<= 1;
+			return p;
+		}
+
+		// 线程第一次录制时创建自己的环并登记；线程退出后环由录制器继续持有，排空后释放
+		Ring& localRing()
+		{
+			return *local_.get([this](std::shared_ptr<Ring>& ring) {
+				ring = std::make_shared<Ring>(ringMask_ + 1);
+				std::lock_guard<std::mutex> lock(registryMutex_);
+				rings_.push_back(ring);
+			});
+		}
+
+		void drain()
+		{
+			std::lock_guard<std::mutex> lock(drainMutex_);
+			std::vector<std::shared_ptr<Ring>> rings;
+			{
+				std::lock_guard<std::mutex> registry(registryMutex_);
+				rings = rings_;
+			}
+			for (auto& ring : rings) {
+				uint64_t head = ring->head.load(std::memory_order_relaxed);
+				uint64_t tail = ring->tail.load(std::memory_order_acquire);
+				for (; head != tail; ++head) encode(ring->slots[head & ringMask_]);
+				ring->head.store(head, std::memory_order_release);
+				if (buffer_.size() >= kWriteChunk) writeBuffer();
+			}
+			writeBuffer();
+			// 只剩录制器持有的环属于已退出的线程，排空后摘除
+			std::lock_guard<std::mutex> registry(registryMutex_);
+			for (size_t i = 0; i < rings_.size();) {
+				Ring& ring = *rings_[i];
+				if (rings_[i].use_count() == 2 && // rings_ 与上面的局部副本
+					ring.head.load(std::memory_order_relaxed) == ring.tail.load(std::memory_order_acquire)) {
+					dropped_ += ring.dropped.load(std::memory_order_relaxed);
+					rings_[i] = rings_.back();
+					rings_.pop_back();
+				}
+				else {
+					++i;
+				}
+			}
+		}
+
+		// 一条记录最长 1 + 10 + 8 + 5 字节，先编码到栈上再整体追加
+		void encode(const AccessRecord& r)
+		{
+			char buf[32];
+			char* p = buf;
+			*p++ = static_cast<char>(static_cast<uint8_t>(r.op) | (r.hit ? 4 : 0));
+			p = trace_format::putVarint(p, trace_format::zigzag(static_cast<int64_t>(r.timestamp - lastTimestamp_)));
+			for (int i = 0; i < 8; ++i) *p++ = static_cast<char>(r.keyHash >> (8 * i));
+			p = trace_format::putVarint(p, r.size);
+			buffer_.append(buf, static_cast<size_t>(p - buf));
+			lastTimestamp_ = r.timestamp;
+			++written_;
+		}
+
+		void writeBuffer()
+		{
+			if (buffer_.empty()) return;
+			out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+			buffer_.clear();
+		}
+
+		static constexpr size_t kWriteChunk = 1 << 16;
+		static constexpr uint64_t kClockEvery = 16;
+
+		KeySampler sampler_;
+		size_t ringMask_;
+		std::chrono::steady_clock::time_point start_;
+		std::mutex registryMutex_; // 保护 rings_ 与 dropped_
+		std::vector<std::shared_ptr<Ring>> rings_;
+		std::mutex drainMutex_;    // 保护文件与编码状态
+		std::ofstream out_;
+		std::string buffer_;
+		uint64_t lastTimestamp_;
+		uint64_t written_;
+		uint64_t dropped_;         // 已摘除的环累计丢弃的记录
+		InstanceLocal<std::shared_ptr<Ring>> local_; // 各线程自己的环
+		std::unique_ptr<ArcMaintainer> flusher_; // 最后声明：后台线程启动时其余成员都已就绪
+	};
+
+	// 给任意 KICachePolicy 加上访问录制。put 不知道键是否已存在，录下的 hit 恒为 false；
+	// valueSize 给出值的大小（例如字符串长度），为空时记 sizeof(Value)，get 未命中时记 0
+	template<typename Key, typename Value, typename Hash = std::hash<Key>>
+	class RecordingCache : public KICachePolicy<Key, Value> {
+	public:
+		RecordingCache(KICachePolicy<Key, Value>& inner, AccessRecorder& recorder, ValueSizer<Value> valueSize = nullptr) :
+			inner_(inner),
+			recorder_(recorder),
+			valueSize_(std::move(valueSize)) {}
+
+		void put(Key key, Value value) override {
+			recorder_.record(static_cast<uint64_t>(hash_(key)), TraceOpType::Put, false, sizeOf(value));
+			inner_.put(std::move(key), std::move(value));
+		}
+
+		bool get(Key key, Value& value) override {
+			uint64_t h = static_cast<uint64_t>(hash_(key));
+			bool hit = inner_.get(std::move(key), value);
+			recorder_.record(h, TraceOpType::Get, hit, hit ? sizeOf(value) : 0);
+			return hit;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(std::move(key), value);
+			return value;
+		}
+
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override { return inner_.memoryUsage(valueSize); }
+
+		std::vector<NamedLockStats> lockStats() override { return inner_.lockStats(); }
+
+	private:
+		uint32_t sizeOf(const Value& value) const
+		{
+			return static_cast<uint32_t>(valueSize_ ? valueSize_(value) : sizeof(Value));
+		}
+
+		KICachePolicy<Key, Value>& inner_;
+		AccessRecorder& recorder_;
+		ValueSizer<Value> valueSize_;
+		Hash hash_;
+	};
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "KArcSampler.h"
+#include "KCacheMutex.h"
+#include "KHashedKey.h"
+
+namespace KArcCache {
+
+	template<typename Key, typename Value, typename Hash, typename KeyEqual> class ArcCache; // 前向声明：影子缓存本身也是 ArcCache
+
+	// 影子缓存自动调参：在哈希采样出的键子集上运行若干个缩小版 ArcCache，
+	// 每个影子使用一组候选 (transformThreshold, LRU 初始占比)，按窗口命中数定期挑出最优配置。
+	// 采样率为 r 时影子容量取 capacity * r，与 SHARDS 的缩放关系一致。
+	// 小缓存的采样率被抬到接近 1，每次访问要驱动 9 个影子，开销数倍于缓存本身：
+	// 因此最优配置连续 kStableEpochs 个窗口不变后进入休眠，跳过 kIdleEpochs 个窗口的采样读，
+	// 醒来先用一个窗口把影子重新预热（不计命中），再恢复比较。负载稳定时影子只在约 1/4 的时间里运行
+	template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class ArcAutoTuner {
+	public:
+		struct Config {
+			size_t transformThreshold;
+			double lruFraction; // LRU 部分占总容量的比例
+		};
+
+		ArcAutoTuner(size_t capacity, size_t transformThreshold, double sampleRate, size_t epochGets) :
+			sampler_(effectiveRate(capacity, sampleRate)),
+			epochGets_(std::max<size_t>(epochGets, 1)),
+			epochCount_(0),
+			current_(0),
+			stableEpochs_(0),
+			warming_(false),
+			idleGets_(0)
+		{
+			size_t scaled = static_cast<size_t>(capacity * sampler_.rate() + 0.5);
+			size_t shadowCapacity = scaled > kMinShadowCapacity ? scaled : kMinShadowCapacity;
+			const size_t thresholds[] = { std::max<size_t>(transformThreshold / 2, 1), transformThreshold, transformThreshold * 2 };
+			const double fractions[] = { 0.25, 0.5, 0.75 };
+			for (size_t threshold : thresholds) {
+				for (double fraction : fractions) {
+					Candidate c;
+					c.config = { threshold, fraction };
+					c.shadow = std::make_unique<Shadow>(shadowCapacity, threshold,
+						static_cast<size_t>(shadowCapacity * fraction));
+					c.hits = 0;
+					if (threshold == transformThreshold && fraction == 0.5) current_ = candidates_.size();
+					candidates_.push_back(std::move(c));
+				}
+			}
+		}
+
+		// 返回 true 表示应当切换到 adopted 配置；key 的哈希值由 ArcCache 算好，影子缓存直接复用
+		bool access(const HashedKey<Key>& key, bool isGet, Config& adopted)
+		{
+			if (!sampler_.sampled(mixHash(key.hash))) return false;
+			// 休眠期只数采样读，不加锁；并发下多减几次只会让休眠稍早结束
+			if (idleGets_.load(std::memory_order_relaxed) > 0) {
+				if (isGet) idleGets_.fetch_sub(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			std::lock_guard<CacheMutex> lock(mutex_);
+			if (!isGet) {
+				for (auto& c : candidates_) c.shadow->put(key, 0);
+				return false;
+			}
+			char unused;
+			for (auto& c : candidates_) {
+				if (c.shadow->get(key, unused) && !warming_) ++c.hits;
+			}
+			if (++epochCount_ < epochGets_) return false;
+			return endEpoch(adopted);
+		}
+
+		Config current()
+		{
+			std::lock_guard<CacheMutex> lock(mutex_);
+			return candidates_[current_].config;
+		}
+
+		void collectLockStats(std::vector<NamedLockStats>& out, const std::string& name) const
+		{
+			appendLockStats(out, name, mutex_);
+		}
+
+	private:
+		using Shadow = ArcCache<Key, char, Hash, KeyEqual>;
+
+		struct Candidate {
+			Config config;
+			std::unique_ptr<Shadow> shadow;
+			uint64_t hits;
+		};
+
+		static constexpr size_t kMinShadowCapacity = 16;
+		static constexpr size_t kStableEpochs = 4;
+		static constexpr size_t kIdleEpochs = 16;
+
+		// 容量太小时按比例放大采样率，保证影子缓存至少有 kMinShadowCapacity 个槽位
+		static double effectiveRate(size_t capacity, double sampleRate)
+		{
+			if (capacity == 0) return 1.0;
+			double minRate = static_cast<double>(kMinShadowCapacity) / capacity;
+			return std::min(1.0, std::max(sampleRate, minRate));
+		}
+
+		bool endEpoch(Config& adopted)
+		{
+			epochCount_ = 0;
+			if (warming_) {
+				warming_ = false;
+				return false;
+			}
+			size_t best = current_;
+			for (size_t i = 0; i < candidates_.size(); ++i) {
+				if (candidates_[i].hits > candidates_[best].hits) best = i;
+			}
+			// 滞回：至少领先当前配置 1% 的窗口读次数才切换，避免来回抖动
+			bool changed = best != current_ &&
+				candidates_[best].hits > candidates_[current_].hits + epochGets_ / 100;
+			if (changed) {
+				current_ = best;
+				adopted = candidates_[best].config;
+			}
+			// 命中数减半而非清零：既跟随负载变化，又保留一部分历史
+			for (auto& c : candidates_) c.hits /= 2;
+			stableEpochs_ = changed ? 0 : stableEpochs_ + 1;
+			if (stableEpochs_ >= kStableEpochs) {
+				stableEpochs_ = 0;
+				warming_ = true;
+				idleGets_.store(static_cast<int64_t>(epochGets_ * kIdleEpochs), std::memory_order_relaxed);
+			}
+			return changed;
+		}
+
+		KeySampler sampler_;
+		size_t epochGets_;
+		size_t epochCount_;
+		size_t current_;
+		size_t stableEpochs_;
+		bool warming_;                 // 休眠刚结束：本窗口只预热影子
+		std::atomic<int64_t> idleGets_; // 休眠期剩余的采样读次数
+		CacheMutex mutex_;
+		std::vector<Candidate> candidates_;
+	};
+}
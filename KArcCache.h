@@ -3,54 +3,224 @@
 #include "KArcCacheNode.h"
 #include "KArcLfuPart.h"
 #include "KArcLruPart.h"
+#include "KArcMrcEstimator.h"
+#include "KArcAutoTuner.h"
+#include "KArcTagRegistry.h"
+#include "KArcScanDetector.h"
+#include "KArcMaintainer.h"
+#include "KAccessRecorder.h"
+#include "KArcSnapshot.h"
+#include "KMappedFile.h"
+#include "KHashedKey.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
 #include <stdexcept> // 用于 get 未找到时抛出异常
 
 namespace KArcCache
 {
-	template<typename Key, typename Value>
+	// Hash / KeyEqual 与 std::unordered_map 的同名参数含义相同；每次操作只哈希一次，
+	// 结果以 HashedKey 形式传给两部分的主表、幽灵表以及 MRC 与自动调参的采样器
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
 	class ArcCache :public KICachePolicy<Key, Value> {
+	public:
+		using KeyType = HashedKey<Key>;
+
 	private:
-		size_t capacity_;
-		size_t transformThreshold_;
-		std::unique_ptr<ArcLfuPart<Key, Value>> lfuPart_;
-		std::unique_ptr<ArcLruPart<Key, Value>> lruPart_;
+		using Tuner = ArcAutoTuner<Key, Hash, KeyEqual>;
+
+		// setCapacity 与自动调参可能和读写并发，两者都是原子量
+		std::atomic<size_t> capacity_;
+		std::atomic<size_t> transformThreshold_;
+		Hash hash_;
+		std::unique_ptr<ArcLfuPart<Key, Value, KeyEqual>> lfuPart_;
+		std::unique_ptr<ArcLruPart<Key, Value, KeyEqual>> lruPart_;
+		ArcTagRegistry tags_;                        // 标签代际表，两部分共享
+		std::unique_ptr<ArcMrcEstimator<Key>> mrc_; // 可选：在线命中率-容量曲线估计
+		std::unique_ptr<Tuner> tuner_;              // 可选：影子缓存自动调参
+		std::unique_ptr<ArcScanDetector<Key>> scan_; // 可选：扫描检测
+		ScanMode scanMode_ = ScanMode::InsertAtTail;
+		// setCapacity 每调用一次 resizeSeq_ 加一；回收追上后 resizeDone_ 记下对应序号
+		std::atomic<uint64_t> resizeSeq_{ 0 };
+		std::atomic<uint64_t> resizeDone_{ 0 };
+		// 两部分之间转移容量（幽灵命中、让槽位、调参）与 setCapacity 互斥，两部分容量之和始终等于 capacity_。
+		// 只在未命中的容量调整路径上加锁，命中路径不经过
+		CacheMutex capacityMutex_;
+
+		size_t headroom_ = 0;                       // 维护任务为每部分预留的空槽数，0 表示未开启维护
+		std::atomic<size_t> insertsSinceNotify_{ 0 };
+		AccessRecorder* recorder_ = nullptr;        // 可选：在线访问录制，由调用方持有
+		ValueSizer<Value> recordSize_;
+		std::unique_ptr<ArcMaintainer> maintainer_; // 可选：后台维护线程；最后声明，析构时最先停止
+
+		// 缩容时每次 put/get 最多顺带逐出的节点数，保证单次操作的额外开销有界
+		static constexpr size_t kResizeEvictBudget = 8;
+		// 维护任务每次 maintain() 每部分最多逐出/裁剪的节点数；幽灵缓存也允许超出这么多条再裁剪
+		static constexpr size_t kMaintainBatch = 64;
+		// 每次持有部分独占锁时最多逐出/裁剪的节点数，块与块之间释放锁，前台写入最多等一小块
+		static constexpr size_t kMaintainChunk = 4;
 
 		// 检查幽灵缓存，并执行 ARC 容量自适应调整
-		bool checkGhostCaches(Key key) {
+		bool checkGhostCaches(const KeyType& key) {
 			bool capacityAdjusted = false;
 
 			// 1. T1 命中 (LRU Ghost) -> 增加 LRU 容量，减少 LFU 容量
-			if (lruPart_->checkGhost(key)) {
-				if (lfuPart_->decreaseCapacity()) {
-					lruPart_->increaseCapacity();
-					capacityAdjusted = true;
-				}
+			bool revived = false;
+			if (lruPart_->checkGhost(key, &revived)) {
+				capacityAdjusted = moveCapacity(*lfuPart_, *lruPart_);
 			}
 
-			// 2. T2 命中 (LFU Ghost) -> 增加 LFU 容量，减少 LRU 容量
-			if (lfuPart_->checkGhost(key)) {
-				if (lruPart_->decreaseCapacity()) {
-					lfuPart_->increaseCapacity();
-					capacityAdjusted = true;
-				}
+			// 2. T2 命中 (LFU Ghost) -> 增加 LFU 容量，减少 LRU 容量。
+			// 已从 LRU 幽灵复活的键不再复活第二份，否则之后的写入只会更新其中一份
+			if (lfuPart_->checkGhost(key, !revived)) {
+				capacityAdjusted = moveCapacity(*lruPart_, *lfuPart_) || capacityAdjusted;
 			}
 			return capacityAdjusted;
 		}
 
+		// 从一部分转一个槽位给另一部分；from 已为 0 时返回 false
+		template<typename From, typename To>
+		bool moveCapacity(From& from, To& to) {
+			std::lock_guard<CacheMutex> lock(capacityMutex_);
+			if (!from.decreaseCapacity()) return false;
+			to.increaseCapacity();
+			return true;
+		}
+
+		// LFU 幽灵命中会把 LRU 部分的容量一步步压到 0，此后新键无处可放，缓存只出不进。
+		// 仿照 ARC 的 REPLACE：新键到来时从 LFU 部分让出一个槽位（已满时逐出频次最低的条目）给 LRU 部分
+		void ensureLruSlot() {
+			if (lruPart_->getCapacity() > 0) return;
+			std::lock_guard<CacheMutex> lock(capacityMutex_);
+			if (lruPart_->getCapacity() == 0 && lfuPart_->decreaseCapacity()) lruPart_->increaseCapacity();
+		}
+
+		// LRU 部分访问次数达到阈值的节点移入 LFU 部分
+		void promoteToLfu(const KeyType& key, const Value& value) {
+			// LFU 部分容量被 ARC 自适应压到 0 时不晋升，否则节点会被直接丢弃
+			if (lfuPart_->getCapacity() == 0) return;
+			if (auto node = lruPart_->take(key)) {
+				lfuPart_->put(key, value, node->getTag(), node->getGeneration());
+			}
+		}
+
+		// 按 ARC 自身的单步调整方式，把 LRU 部分容量逐步移向 lruCapacity
+		void rebalance(size_t lruCapacity) {
+			std::lock_guard<CacheMutex> lock(capacityMutex_);
+			lruCapacity = std::min(lruCapacity, getCapacity());
+			while (lruPart_->getCapacity() > lruCapacity && lruPart_->decreaseCapacity()) {
+				lfuPart_->increaseCapacity();
+			}
+			while (lruPart_->getCapacity() < lruCapacity && lfuPart_->decreaseCapacity()) {
+				lruPart_->increaseCapacity();
+			}
+		}
+
+		void continueShrink() {
+			uint64_t done = resizeDone_.load(std::memory_order_acquire);
+			uint64_t seq = resizeSeq_.load(std::memory_order_acquire);
+			if (seq == done) return;
+			bool lruDone = lruPart_->evictExcess(kResizeEvictBudget);
+			bool lfuDone = lfuPart_->evictExcess(kResizeEvictBudget);
+			// 期间若又有 setCapacity，seq 已过期，下次操作继续回收
+			if (lruDone && lfuDone) resizeDone_.compare_exchange_strong(done, seq);
+		}
+
+		// 新键消耗了空槽；每用掉半个 headroom 唤醒一次后台线程，避免每次写入都付出一次唤醒的系统调用
+		void noteInserts(size_t n) {
+			if (!maintainer_ || n == 0) return;
+			if (insertsSinceNotify_.fetch_add(n, std::memory_order_relaxed) + n >= (headroom_ + 1) / 2) {
+				insertsSinceNotify_.store(0, std::memory_order_relaxed);
+				maintainer_->notify();
+			}
+		}
+
+		void record(const KeyType& key, TraceOpType op, bool hit, const Value* value) {
+			if (!recorder_->sampled(static_cast<uint64_t>(key.hash))) return;
+			uint32_t size = 0;
+			if (value) size = static_cast<uint32_t>(recordSize_ ? recordSize_(*value) : sizeof(Value));
+			recorder_->record(static_cast<uint64_t>(key.hash), op, hit, size);
+		}
+
+		void observe(const KeyType& key, bool isGet) {
+			continueShrink();
+			if (mrc_) mrc_->accessHashed(mixHash(key.hash), isGet);
+			if (tuner_) {
+				typename Tuner::Config config;
+				if (tuner_->access(key, isGet, config)) {
+					setTransformThreshold(config.transformThreshold);
+					rebalance(static_cast<size_t>(getCapacity() * config.lruFraction));
+				}
+			}
+		}
+
+		// 两部分依次查找，未命中时经幽灵缓存调整容量后再查一次
+		bool lookup(const KeyType& key, Value& value) {
+			observe(key, true);
+			if (scan_) scan_->access(key.key); // 读也推进步长跟踪，读写交错的扫描同样能被识别
+
+			bool shouldTransform = false;
+			if (lruPart_->get(key, value, shouldTransform)) {
+				if (scan_) scan_->recordOutcome(true);
+				if (shouldTransform) promoteToLfu(key, value);
+				return true;
+			}
+			if (lfuPart_->get(key, value)) {
+				if (scan_) scan_->recordOutcome(true);
+				return true;
+			}
+
+			// miss：检查 ghost，再次尝试；幽灵命中（触发了容量调整）说明键被重用，不算冷未命中
+			bool adjusted = checkGhostCaches(key);
+			if (scan_) scan_->recordOutcome(adjusted);
+			if (adjusted) {
+				if (lruPart_->get(key, value, shouldTransform)) {
+					if (shouldTransform) promoteToLfu(key, value);
+					return true;
+				}
+				if (lfuPart_->get(key, value)) return true;
+			}
+			return false;
+		}
 
 	public:
 		// 构造函数：将总容量 capacity 平均分配给 LRU 和 LFU 部分
 		explicit ArcCache(size_t capacity = 20, size_t transformThreshold = 2) :
+			ArcCache(capacity, transformThreshold, capacity / 2) {
+
+		}
+		// 指定 LRU 部分的初始容量，其余分给 LFU 部分
+		ArcCache(size_t capacity, size_t transformThreshold, size_t lruCapacity) :
 			capacity_(capacity),
 			transformThreshold_(transformThreshold),
-			lfuPart_(std::make_unique <ArcLfuPart<Key, Value>>(capacity / 2, transformThreshold)),
-			lruPart_(std::make_unique <ArcLruPart<Key, Value>>(capacity / 2, transformThreshold)) {
-
+			lfuPart_(std::make_unique <ArcLfuPart<Key, Value, KeyEqual>>(capacity - std::min(lruCapacity, capacity), transformThreshold)),
+			lruPart_(std::make_unique <ArcLruPart<Key, Value, KeyEqual>>(std::min(lruCapacity, capacity), transformThreshold)) {
+			lfuPart_->setTagRegistry(&tags_);
+			lruPart_->setTagRegistry(&tags_);
 		}
 		~ArcCache() override = default;
 
+		// 预先计算键的哈希；同一个键反复访问时可以只算一次，之后调用接收 KeyType 的重载
+		KeyType hashKey(Key key) const {
+			return makeHashedKey(hash_, std::move(key));
+		}
+
 		// 实现 KICachePolicy::put - 插入或更新缓存项
 		void put(Key key, Value value) override {
+			put(hashKey(std::move(key)), value, ArcTagRegistry::kNoTag);
+		}
+
+		// 带标签写入：invalidateTag(tag) 之后该条目在下次查找时视为未命中
+		void put(Key key, Value value, uint64_t tag) {
+			put(hashKey(std::move(key)), value, tag);
+		}
+
+		void put(const KeyType& key, const Value& value, uint64_t tag = ArcTagRegistry::kNoTag) {
+			observe(key, false);
+			uint64_t generation = tags_.generation(tag);
+			bool scan = scan_ && scan_->access(key.key);
+
 			// 1. 检查并执行 ARC 容量调整（Ghost Cache 命中时）
 			//顶部调用 `checkGhostCaches(key)`。这会把“写入”也当成访问信号，
 			// 30% 写入时 ARC 会频繁错调容量，命中率被拖垮。把 ghost 自适应放到 **get 未命中** 时，再决定是否提升：
@@ -58,29 +228,61 @@ namespace KArcCache
 
 			// 2. 执行 put 操作：优先检查 LFU（频率更高），否则交给 LRU
 			if (lfuPart_->contain(key)) {
-				lfuPart_->put(key, value);
+				if (scan_) scan_->recordOutcome(true);
+				if (recorder_) record(key, TraceOpType::Put, true, &value);
+				lfuPart_->put(key, value, tag, generation);
 				return;
 			}
 			if (lruPart_->contain(key)) { 
-				lruPart_->put(key, value);
+				if (scan_) scan_->recordOutcome(true);
+				if (recorder_) record(key, TraceOpType::Put, true, &value);
+				lruPart_->put(key, value, tag, generation);
 				return; 
 			}
-			// 新节点，或 LRU 部分的节点（包括刚刚从 Ghost 提升上来的节点）
-			lruPart_->put(key, value);
+			// 新节点：属于扫描时插在 LRU 尾部或不缓存，不挤出工作集。
+			// LFU 幽灵里可能存着这个键的旧值，不作废的话日后幽灵命中会复活旧值（LRU 幽灵中的同一个键会在逐出时被替换）；
+			// 旁路不缓存时 LRU 幽灵的旧值同样要作废
+			if (scan_) scan_->recordOutcome(false);
+			if (recorder_) record(key, TraceOpType::Put, false, &value);
+			lfuPart_->retireGhost(key);
+			ensureLruSlot();
+			if (scan) {
+				if (scanMode_ == ScanMode::InsertAtTail) lruPart_->putAtTail(key, value, tag, generation);
+				else lruPart_->retireGhost(key);
+				return;
+			}
+			lruPart_->put(key, value, tag, generation);
+			noteInserts(1);
+		}
+
+		// 批量写入（写缓冲排空时使用），条目不打标签：先在 LFU 部分更新已有的键，剩下的整批交给 LRU 部分，
+		// 两部分各只加一次锁。开启扫描检测时逐个走 put，保持扫描判定与单次写入一致
+		void putBatch(const std::vector<std::pair<KeyType, Value>>& writes) {
+			if (scan_) {
+				for (const auto& w : writes) put(w.first, w.second);
+				return;
+			}
+			for (const auto& w : writes) {
+				observe(w.first, false);
+				if (recorder_) record(w.first, TraceOpType::Put, false, &w.second); // 批内不区分更新与插入
+			}
+			std::vector<const std::pair<KeyType, Value>*> rest;
+			rest.reserve(writes.size());
+			lfuPart_->updateBatch(writes, rest);
+			if (!rest.empty()) ensureLruSlot();
+			lruPart_->putBatch(rest);
+			noteInserts(rest.size());
 		}
 
 		// 实现 KICachePolicy::get (带传出参数) - 查找缓存项
 		bool get(Key key, Value& value) override {
-			if (lruPart_->get(key, value)) return true;
-			if (lfuPart_->get(key, value)) return true;
+			return get(hashKey(std::move(key)), value);
+		}
 
-			// miss：检查 ghost，再次尝试
-			bool adjusted = checkGhostCaches(key);
-			if (adjusted) {
-				if (lruPart_->get(key, value)) return true;
-				if (lfuPart_->get(key, value)) return true;
-			}
-			return false;
+		bool get(const KeyType& key, Value& value) {
+			bool hit = lookup(key, value);
+			if (recorder_) record(key, TraceOpType::Get, hit, hit ? &value : nullptr);
+			return hit;
 		}
 
 		// 实现 KICachePolicy::get (直接返回值) - 查找缓存项
@@ -92,5 +294,218 @@ namespace KArcCache
 			// 最佳实践：如果未找到，抛出异常
 			return value;
 		}
+
+		// 开始把每次 put/get（键的哈希、命中与否、值的大小）录入 recorder，nullptr 停止录制。
+		// valueSize 为空时值的大小记 sizeof(Value)。recorder 由调用方持有，需在并发访问开始前调用
+		void setRecorder(AccessRecorder* recorder, ValueSizer<Value> valueSize = nullptr) {
+			recorder_ = recorder;
+			recordSize_ = std::move(valueSize);
+		}
+
+		// 开启在线 MRC 估计：按 sampleRate 对键做哈希采样，曲线覆盖到 maxCapacity（默认 4 倍当前容量）。
+		// 需在并发访问开始前调用
+		void enableMissRatioCurve(double sampleRate = 0.001, size_t maxCapacity = 0, size_t maxSamples = 8192) {
+			if (maxCapacity == 0) maxCapacity = getCapacity() * 4;
+			mrc_ = std::make_unique<ArcMrcEstimator<Key>>(maxCapacity, sampleRate, maxSamples);
+		}
+
+		void disableMissRatioCurve() { mrc_.reset(); }
+
+		// 估计的命中率-容量曲线；未开启时返回空
+		std::vector<MrcPoint> hitRatioCurve() {
+			return mrc_ ? mrc_->hitRatioCurve() : std::vector<MrcPoint>();
+		}
+
+		double estimateHitRatio(size_t capacity) {
+			return mrc_ ? mrc_->estimateHitRatio(capacity) : 0.0;
+		}
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			lruPart_->collectLockStats(stats, "arc.lru");
+			lfuPart_->collectLockStats(stats, "arc.lfu");
+			appendLockStats(stats, "arc.capacity", capacityMutex_);
+			if (mrc_) mrc_->collectLockStats(stats, "arc.mrc");
+			if (tuner_) tuner_->collectLockStats(stats, "arc.tuner");
+			return stats;
+		}
+
+		// 删除单个键（包括幽灵缓存中的记录），返回是否删除了常驻条目
+		bool erase(Key key) {
+			return erase(hashKey(std::move(key)));
+		}
+
+		bool erase(const KeyType& key) {
+			bool erased = lruPart_->erase(key);
+			erased = lfuPart_->erase(key) || erased;
+			return erased;
+		}
+
+		// O(1) 批量失效：只递增标签代际，过期条目在查找时惰性删除、在淘汰时优先回收
+		void invalidateTag(uint64_t tag) { tags_.invalidate(tag); }
+
+		// 运行时调整总容量，按当前 LRU/LFU 占比分配给两部分（幽灵缓存容量同步调整）。
+		// 扩容立即生效；缩容只改上限，超出的节点在之后的 put/get 中每次最多逐出 kResizeEvictBudget 个
+		void setCapacity(size_t capacity) {
+			std::lock_guard<CacheMutex> lock(capacityMutex_);
+			size_t lruCapacity = lruPart_->getCapacity();
+			size_t total = lruCapacity + lfuPart_->getCapacity();
+			size_t newLru = total ? static_cast<size_t>(static_cast<double>(capacity) * lruCapacity / total) : capacity / 2;
+			capacity_ = capacity;
+			lruPart_->setCapacity(newLru);
+			lfuPart_->setCapacity(capacity - newLru);
+			resizeSeq_.fetch_add(1, std::memory_order_release);
+		}
+
+		size_t getCapacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+		// 两部分主缓存的条目数之和。缩容后超出的条目分批回收，size() 会暂时大于 getCapacity()
+		size_t size() {
+			return lruPart_->size() + lfuPart_->size();
+		}
+
+		// 两部分之和；MRC 估计与自动调参的采样结构不计入
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			MemoryUsage usage = lruPart_->memoryUsage(valueSize);
+			usage += lfuPart_->memoryUsage(valueSize);
+			return usage;
+		}
+
+		// LRU 部分命中次数达到阈值后晋升到 LFU 部分
+		void setTransformThreshold(size_t transformThreshold) {
+			transformThreshold_ = transformThreshold;
+			lruPart_->setTransformThreshold(transformThreshold);
+		}
+
+		size_t getTransformThreshold() const { return transformThreshold_.load(std::memory_order_relaxed); }
+
+		// 开启自动调参：在 sampleRate 采样的键上运行 9 个影子缓存（3 个阈值 x 3 种初始划分），
+		// 每 epochGets 次采样读比较一次，采用命中最多的配置。需在并发访问开始前调用
+		void enableAutoTuning(double sampleRate = 0.01, size_t epochGets = 2000) {
+			tuner_ = std::make_unique<Tuner>(getCapacity(), getTransformThreshold(), sampleRate, epochGets);
+		}
+
+		void disableAutoTuning() { tuner_.reset(); }
+
+		// 开启扫描检测：整数键连续 minRun 次按 +1/-1 步长访问，或连续 minStreak 次冷未命中（不在缓存和幽灵缓存中），
+		// 之后写入的新键按 mode 插到 LRU 尾部或不缓存。需在并发访问开始前调用
+		void enableScanDetection(ScanMode mode = ScanMode::InsertAtTail, size_t minRun = 8, size_t minStreak = 64) {
+			scanMode_ = mode;
+			scan_ = std::make_unique<ArcScanDetector<Key>>(minRun, minStreak);
+		}
+
+		void disableScanDetection() { scan_.reset(); }
+
+		// 开启维护：两部分都保持 headroom 个空槽（0 取容量的 1/64，至少 1 个），幽灵缓存允许超出
+		// kMaintainBatch 条再成批裁剪，写入新键时通常只需插入，不必同步逐出。代价是常驻条目少 2 * headroom 个。
+		// backgroundThread 为 true 时由后台线程在空槽用掉一半后执行 maintain()，空闲时每隔 interval 才醒一次；
+		// 为 false 时由调用方在自己的定时器或空闲循环里调用 maintain()。需在并发访问开始前调用
+		void enableMaintenance(size_t headroom = 0, bool backgroundThread = true,
+			std::chrono::milliseconds interval = std::chrono::milliseconds(100)) {
+			maintainer_.reset();
+			headroom_ = headroom ? headroom : std::max<size_t>(1, getCapacity() / 64);
+			lruPart_->setGhostSlack(kMaintainBatch);
+			lfuPart_->setGhostSlack(kMaintainBatch);
+			if (backgroundThread) {
+				maintainer_ = std::make_unique<ArcMaintainer>([this] { return maintain(); }, interval);
+			}
+		}
+
+		void disableMaintenance() {
+			maintainer_.reset();
+			headroom_ = 0;
+			lruPart_->setGhostSlack(0);
+			lfuPart_->setGhostSlack(0);
+		}
+
+		// 执行一批维护：每部分最多逐出/裁剪 kMaintainBatch 个节点，返回 true 表示两部分都已达标。
+		// 每次加独占锁只处理 kMaintainChunk 个，两部分交替进行，前台请求不会被整批逐出挡住。
+		// 已留足空槽的部分只在共享锁下看一眼，不去抢独占锁（独占加锁还要回放读缓冲）
+		bool maintain() {
+			if (headroom_ == 0) return true;
+			bool lruDone = lruPart_->hasHeadroom(headroom_);
+			bool lfuDone = lfuPart_->hasHeadroom(headroom_);
+			for (size_t n = 0; n < kMaintainBatch && !(lruDone && lfuDone); n += kMaintainChunk) {
+				if (!lruDone) lruDone = lruPart_->evictExcess(kMaintainChunk, headroom_);
+				if (!lfuDone) lfuDone = lfuPart_->evictExcess(kMaintainChunk, headroom_);
+			}
+			return lruDone && lfuDone;
+		}
+
+		// 把常驻条目（LRU 顺序、LFU 频次）、两部分幽灵缓存、容量划分与晋升阈值写入 path，键与值按 SnapshotCodec 编码。
+		// 每部分先在独占锁下拷出节点指针（不编码），再在共享锁下每批 256 个地编码，批间放开锁，写文件时不持锁。
+		// 独占锁只在拷指针时持有，之后写入与逐出只需等一批；读在批内也能继续。
+		// 快照因此不是同一时刻的状态：拷出后被逐出或删除的条目不写入，新写入的不在快照中；
+		// 先编码 LRU 部分，间隙中晋升的键会同时出现在两部分，恢复时以 LFU 部分为准
+		bool snapshot(const std::string& path) {
+			SnapshotWriter lru;
+			SnapshotWriter lfu;
+			size_t lruCapacity = lruPart_->getCapacity();
+			size_t lfuCapacity = lfuPart_->getCapacity();
+			lruPart_->snapshot(lru);
+			lfuPart_->snapshot(lfu);
+			SnapshotWriter out;
+			out.putRaw(snapshot_format::kMagic, sizeof(snapshot_format::kMagic));
+			out.putU32(snapshot_format::kVersion);
+			out.putU64(getCapacity());
+			out.putU64(getTransformThreshold());
+			out.putU64(lruCapacity);
+			out.putU64(lfuCapacity);
+			out.append(lfu);
+			out.append(lru);
+			return out.writeFile(path);
+		}
+
+		// 从 snapshot 写出的文件（内存映射读取）重建缓存，原有内容丢弃。容量仍是本实例的容量，
+		// LRU/LFU 划分按快照中的比例缩放，放不下时丢弃最旧 / 频次最低的条目。
+		// 文件缺失、格式不符或数据不完整时返回 false，缓存为空。需在并发访问开始前调用
+		bool restore(const std::string& path) {
+			MappedFile file(path);
+			if (!file.valid()) return false;
+			SnapshotReader in(file.data(), file.size());
+			char magic[sizeof(snapshot_format::kMagic)];
+			uint32_t version = 0;
+			uint64_t capacity = 0, threshold = 0, lruCapacity = 0, lfuCapacity = 0;
+			if (!in.getRaw(magic, sizeof(magic)) || std::memcmp(magic, snapshot_format::kMagic, sizeof(magic)) != 0
+				|| !in.getU32(version) || version != snapshot_format::kVersion
+				|| !in.getU64(capacity) || !in.getU64(threshold) || !in.getU64(lruCapacity) || !in.getU64(lfuCapacity)) {
+				return false;
+			}
+			uint64_t total = lruCapacity + lfuCapacity;
+			size_t ownCapacity = getCapacity();
+			size_t newLru = total ? static_cast<size_t>(static_cast<double>(ownCapacity) * lruCapacity / total) : ownCapacity / 2;
+			setTransformThreshold(static_cast<size_t>(threshold));
+			auto hash = [this](Key key) { return hashKey(std::move(key)); };
+			bool ok = lfuPart_->restore(in, ownCapacity - newLru, hash, [](const KeyType&) { return false; })
+				&& lruPart_->restore(in, newLru, hash, [this](const KeyType& key) { return lfuPart_->contain(key); });
+			if (!ok) {
+				lruPart_->clear();
+				lfuPart_->clear();
+			}
+			return ok;
+		}
+
+		// 开启读缓冲：命中只加部分的共享锁，访问记入有损的条带化缓冲，攒满一条带或下一次独占加锁
+		// （写入、逐出、晋升）时再回放到 LRU 链表与 LFU 频次桶。读多的负载下独占加锁次数大幅减少，
+		// 代价是顺序近似：缓冲满且抢不到锁时访问被丢弃，晋升也可能推迟。需在并发访问开始前调用
+		void enableReadBuffers() {
+			lruPart_->setReadBuffer(true);
+			lfuPart_->setReadBuffer(true);
+		}
+
+		void disableReadBuffers() {
+			lruPart_->setReadBuffer(false);
+			lfuPart_->setReadBuffer(false);
+		}
+
+		// 读缓冲因条带已满而丢弃的访问次数
+		uint64_t droppedReads() const {
+			return lruPart_->droppedReads() + lfuPart_->droppedReads();
+		}
+
+		// 主缓存已满、只能在前台同步逐出的次数（写入新键与幽灵复活），维护跟不上写入时会增长
+		uint64_t foregroundEvictions() {
+			return lruPart_->foregroundEvictions() + lfuPart_->foregroundEvictions();
+		}
 	};
 };
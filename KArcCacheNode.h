@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <list>
 #include <memory>
 
 namespace KArcCache {
@@ -11,21 +13,32 @@ namespace KArcCache {
 		std::shared_ptr<ArcNode> next_;
 		std::weak_ptr<ArcNode> prev_;
 		size_t accessCount_;
+		size_t hash_;         // 键的哈希值，由所属部分在插入时记下，删除时不必重新哈希
+		uint64_t tag_;        // 所属标签，0 表示未打标签
+		uint64_t generation_; // 写入时标签的代际
+		bool hasValue_;       // 幽灵节点的值被作废（键已重新写入）后为 false，命中只用于自适应，不再复活
+		typename std::list<std::shared_ptr<ArcNode>>::iterator freqPos_; // 在 LFU 部分频次桶中的位置，摘除时不必遍历桶
 	public:
-		ArcNode():accessCount_(1), next_(nullptr) {}
-		ArcNode(Key key,Value value) :key_(key),value_(value),accessCount_(1), next_(nullptr){}
+		ArcNode():accessCount_(1), hash_(0), tag_(0), generation_(0), hasValue_(true), next_(nullptr) {}
+		ArcNode(Key key,Value value, size_t hash = 0) :key_(key),value_(value),accessCount_(1), hash_(hash), tag_(0), generation_(0), hasValue_(true), next_(nullptr){}
 		
 		//getters
 		Key getKey()const { return key_; }
 		Value getValue()const { return value_; }
 		size_t getAccessCount()const { return accessCount_; }
+		size_t getHash()const { return hash_; }
+		uint64_t getTag()const { return tag_; }
+		uint64_t getGeneration()const { return generation_; }
+		bool hasValue()const { return hasValue_; }
 
 		//setters
 		void setValue(Value value) { value_ = value; }
 		void increaseAccessCount() { accessCount_++; }
+		void setTag(uint64_t tag, uint64_t generation) { tag_ = tag; generation_ = generation; }
+		void dropValue() { value_ = Value(); hasValue_ = false; }
 
-		template<typename Key, typename Value> friend class ArcLruPart;
-		template<typename Key, typename Value> friend class ArcLfuPart;
+		template<typename K, typename V, typename E> friend class ArcLruPart;
+		template<typename K, typename V, typename E> friend class ArcLfuPart;
 
 	};
 }
\ No newline at end of file
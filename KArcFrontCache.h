@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KArcCache.h"
+#include "KArcSampler.h"
+#include "KInstanceLocal.h"
+
+namespace KArcCache {
+
+	// 线程本地 L1 前端缓存：每个线程一个小的直接映射表，热点键的读命中不触碰共享 ArcCache 的任何锁。
+	// 一致性：键按哈希分到若干条带，任意线程 put/erase 某键后递增其条带版本（invalidateTag 递增全局纪元），
+	// L1 条目记录填充时的版本，读时版本不一致即视为失效。
+	// 有界陈旧：L1 条目自填充起被本线程命中 maxAge 次后强制回源一次，顺带刷新共享缓存里的访问顺序。
+	// 各线程的 L1 随 ArcFrontCache 销毁而作废，由 InstanceLocal 在该线程下次新建表项或退出时释放
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class ArcFrontCache : public KICachePolicy<Key, Value> {
+	public:
+		using Shared = ArcCache<Key, Value, Hash, KeyEqual>;
+
+		explicit ArcFrontCache(Shared& shared, size_t l1Slots = 64, size_t maxAge = 1024) :
+			shared_(shared),
+			slotMask_(roundUpPow2(l1Slots) - 1),
+			maxAge_(maxAge),
+			epoch_(0),
+			stripes_(new Stripe[kStripes]) {}
+
+		~ArcFrontCache() override = default;
+
+		// 键只哈希一次：条带定位与共享缓存的各张表共用 ArcCache 算出的哈希值
+		void put(Key key, Value value) override {
+			auto hk = shared_.hashKey(std::move(key));
+			uint64_t h = mixHash(hk.hash);
+			shared_.put(hk, value);
+			// 先写共享缓存再递增版本：读线程若在递增前拿到旧值，它记下的版本必然已过期
+			bumpStripe(h);
+		}
+
+		void put(Key key, Value value, uint64_t tag) {
+			auto hk = shared_.hashKey(std::move(key));
+			uint64_t h = mixHash(hk.hash);
+			shared_.put(hk, value, tag);
+			bumpStripe(h);
+		}
+
+		bool get(Key key, Value& value) override {
+			auto hk = shared_.hashKey(std::move(key));
+			uint64_t h = mixHash(hk.hash);
+			Slot& slot = localSlots()[h & slotMask_];
+			uint64_t version = stripeVersion(h);
+			uint64_t epoch = epoch_.load(std::memory_order_acquire);
+
+			if (slot.valid && KeyEqual()(slot.key, hk.key) && slot.version == version && slot.epoch == epoch &&
+				++slot.served <= maxAge_) {
+				value = slot.value;
+				return true;
+			}
+
+			if (!shared_.get(hk, value)) {
+				if (slot.valid && KeyEqual()(slot.key, hk.key)) slot.valid = false;
+				return false;
+			}
+			slot.key = hk.key;
+			slot.value = value;
+			slot.version = version;
+			slot.epoch = epoch;
+			slot.served = 0;
+			slot.valid = true;
+			return true;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		bool erase(Key key) {
+			auto hk = shared_.hashKey(std::move(key));
+			uint64_t h = mixHash(hk.hash);
+			bool erased = shared_.erase(hk);
+			bumpStripe(h);
+			return erased;
+		}
+
+		// 标签失效无法定位到具体键，直接让所有线程的 L1 整体失效
+		void invalidateTag(uint64_t tag) {
+			shared_.invalidateTag(tag);
+			epoch_.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		// 只统计共享缓存；各线程的 L1 副本最多 l1Slots 个
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			return shared_.memoryUsage(valueSize);
+		}
+
+	private:
+		static constexpr size_t kStripes = 256;
+
+		// 每个条带补齐到 64 字节，相邻版本号相距一整条缓存行，不同键的写入不会伪共享。
+		// 不用 alignas(64)：C++14 的 new 不保证超对齐，g++ 报 -Waligned-new、MSVC 报 C4316
+		struct Stripe {
+			std::atomic<uint64_t> version{ 0 };
+			char pad[64 - sizeof(std::atomic<uint64_t>)];
+		};
+
+		struct Slot {
+			Key key{};
+			Value value{};
+			uint64_t version = 0;
+			uint64_t epoch = 0;
+			size_t served = 0; // 自填充起的命中次数
+			bool valid = false;
+		};
+
+		static size_t roundUpPow2(size_t n)
+		{
+			size_t p = 1;
+			while (p < n) p <<= 1;
+			return p;
+		}
+
+		std::vector<Slot>& localSlots()
+		{
+			return local_.get([this](std::vector<Slot>& slots) { slots.resize(slotMask_ + 1); });
+		}
+
+		size_t stripeOf(uint64_t h) const { return static_cast<size_t>(h >> 56) & (kStripes - 1); }
+
+		uint64_t stripeVersion(uint64_t h) const
+		{
+			return stripes_[stripeOf(h)].version.load(std::memory_order_acquire);
+		}
+
+		void bumpStripe(uint64_t h)
+		{
+			stripes_[stripeOf(h)].version.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		Shared& shared_;
+		size_t slotMask_;
+		size_t maxAge_;
+		std::atomic<uint64_t> epoch_;
+		std::unique_ptr<Stripe[]> stripes_;
+		InstanceLocal<std::vector<Slot>> local_;
+	};
+}
@@ -0,0 +1,424 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace KArcCache {
+
+	// 下标链接 ARC 的空下标与节点所在位置，ArcIndexCore 与各存储共用
+	struct ArcIndex {
+		static constexpr uint32_t kNil = UINT32_MAX;
+		enum : uint8_t { kFree, kLruMain, kLruGhost, kLfuMain, kLfuGhost };
+	};
+
+	// CompactArcCache（进程内数组）与 ShmArcCache（共享内存段内按偏移定位的数组）共用的替换算法：
+	// 与 ArcCache 相同，LRU 部分的键访问达到 transformThreshold 次后移入 LFU 部分，两部分各有保存值的幽灵缓存，
+	// 幽灵命中时复活并在两部分之间挪动一个容量。节点、频次桶与两部分的状态都由 Derived 存放，本类只按 32 位下标操作，
+	// 自身不持有状态、不加锁（调用方在自己的锁内调用）。
+	// Layout 给出 Key、Value、HashValue 与 List / Node / FreqBucket / Part 四个结构，字段名见下面的用法；
+	// Derived 需提供（可为私有，声明本类为友元）：nodes()、buckets()、lruPart()、lfuPart()、freeNodeHead()、
+	// freeBucketHead()、transformThreshold()，以及每部分的哈希索引 find / linkIndex / unlinkIndex
+	template<typename Derived, typename Layout>
+	class ArcIndexCore : public ArcIndex {
+	protected:
+		using Key = typename Layout::Key;
+		using Value = typename Layout::Value;
+		using HashValue = typename Layout::HashValue;
+		using List = typename Layout::List;
+		using Node = typename Layout::Node;
+		using FreqBucket = typename Layout::FreqBucket;
+		using Part = typename Layout::Part;
+
+		// 与 ArcCache::put 相同：已有的键就地更新（LFU 部分同时算一次访问），新键进入 LRU 部分
+		void putEntry(const Key& key, HashValue h, const Value& value)
+		{
+			Node* nodes = self().nodes();
+			Part& lru = self().lruPart();
+			Part& lfu = self().lfuPart();
+			uint32_t i = self().find(lfu, key, h);
+			if (i != kNil && nodes[i].where == kLfuMain) {
+				nodes[i].value = value;
+				touchLfu(i);
+				return;
+			}
+			i = self().find(lru, key, h);
+			if (i != kNil && nodes[i].where == kLruMain) {
+				nodes[i].value = value;
+				return;
+			}
+			// LFU 幽灵里的旧值作废，否则日后幽灵命中会复活它
+			uint32_t g = self().find(lfu, key, h);
+			if (g != kNil) dropValue(g);
+			// 同 ArcCache::ensureLruSlot：LFU 幽灵命中把 LRU 容量挪空后，新键从 LFU 部分借回一个槽位
+			if (lru.capacity == 0 && decreaseCapacity(lfu)) ++lru.capacity;
+			if (lru.capacity == 0) {
+				if (i != kNil) dropValue(i);
+				return;
+			}
+			// 每部分每个键只有一个节点：本部分幽灵中的同一个键直接换成新写入的主缓存节点
+			if (i != kNil) {
+				unlink(lru.ghost, i);
+			}
+			else {
+				// 先逐出再取空闲节点：节点数按主缓存与幽灵缓存各自的上限分配，逐出会让满了的幽灵缓存让出一个节点
+				if (lru.main.size >= lru.capacity) evict(lru);
+				i = allocateNode();
+				if (i == kNil) return;
+				nodes[i].key = key;
+				nodes[i].hash = h;
+				self().linkIndex(lru, i);
+			}
+			nodes[i].value = value;
+			nodes[i].hasValue = true;
+			attachMain(lru, i);
+		}
+
+		// 未命中时检查两部分的幽灵缓存并调整容量，复活的键再查一次
+		bool getEntry(const Key& key, HashValue h, Value& value)
+		{
+			if (lookup(key, h, value)) return true;
+			return checkGhosts(key, h) && lookup(key, h, value);
+		}
+
+		// 删除单个键（包括两部分幽灵缓存中的记录），返回是否删除了常驻条目
+		bool eraseEntry(const Key& key, HashValue h)
+		{
+			Node* nodes = self().nodes();
+			bool erased = false;
+			for (Part* p : { &self().lruPart(), &self().lfuPart() }) {
+				uint32_t i = self().find(*p, key, h);
+				if (i == kNil) continue;
+				uint8_t where = nodes[i].where;
+				if (where == kLruMain || where == kLfuMain) erased = true;
+				detach(*p, i);
+				self().unlinkIndex(*p, i);
+				freeNode(i);
+			}
+			return erased;
+		}
+
+		size_t entryCount() { return static_cast<size_t>(self().lruPart().main.size + self().lfuPart().main.size); }
+
+		// 清空两部分的链表并把容量恢复为均分；哈希索引由 Derived 自己清空
+		void resetParts(size_t capacity)
+		{
+			Part& lru = self().lruPart();
+			Part& lfu = self().lfuPart();
+			for (Part* p : { &lru, &lfu }) {
+				p->main = List{ kNil, kNil, 0 };
+				p->ghost = List{ kNil, kNil, 0 };
+				p->freqHead = p->freqTail = kNil;
+			}
+			lru.capacity = lru.ghostCapacity = capacity / 2;
+			lfu.capacity = lfu.ghostCapacity = capacity - capacity / 2;
+		}
+
+		// 全部节点与频次桶重新构造，各自串成空闲链表
+		void resetFreeLists(uint32_t nodeCount, uint32_t bucketCount)
+		{
+			Node* nodes = self().nodes();
+			for (uint32_t i = 0; i < nodeCount; ++i) {
+				new (&nodes[i]) Node();
+				nodes[i].where = kFree;
+				nodes[i].next = i + 1 < nodeCount ? i + 1 : kNil;
+			}
+			self().freeNodeHead() = nodeCount ? 0 : kNil;
+			FreqBucket* buckets = self().buckets();
+			for (uint32_t i = 0; i < bucketCount; ++i) {
+				new (&buckets[i]) FreqBucket();
+				buckets[i].next = i + 1 < bucketCount ? i + 1 : kNil;
+			}
+			self().freeBucketHead() = bucketCount ? 0 : kNil;
+		}
+
+	private:
+		Derived& self() { return static_cast<Derived&>(*this); }
+
+		// ---- 节点与链表 ----
+
+		uint32_t allocateNode()
+		{
+			Node* nodes = self().nodes();
+			uint32_t& head = self().freeNodeHead();
+			uint32_t i = head;
+			if (i == kNil) return kNil;
+			head = nodes[i].next;
+			nodes[i].prev = nodes[i].next = nodes[i].bucket = kNil;
+			nodes[i].accessCount = 1;
+			nodes[i].hasValue = true;
+			return i;
+		}
+
+		void freeNode(uint32_t i)
+		{
+			Node& n = self().nodes()[i];
+			uint32_t& head = self().freeNodeHead();
+			n.value = Value();
+			n.where = kFree;
+			n.next = head;
+			head = i;
+		}
+
+		void pushFront(List& list, uint32_t i)
+		{
+			Node* nodes = self().nodes();
+			nodes[i].prev = kNil;
+			nodes[i].next = list.head;
+			if (list.head != kNil) nodes[list.head].prev = i;
+			else list.tail = i;
+			list.head = i;
+			++list.size;
+		}
+
+		void pushBack(List& list, uint32_t i)
+		{
+			Node* nodes = self().nodes();
+			nodes[i].next = kNil;
+			nodes[i].prev = list.tail;
+			if (list.tail != kNil) nodes[list.tail].next = i;
+			else list.head = i;
+			list.tail = i;
+			++list.size;
+		}
+
+		void unlink(List& list, uint32_t i)
+		{
+			Node* nodes = self().nodes();
+			Node& n = nodes[i];
+			if (n.prev != kNil) nodes[n.prev].next = n.next;
+			else list.head = n.next;
+			if (n.next != kNil) nodes[n.next].prev = n.prev;
+			else list.tail = n.prev;
+			n.prev = n.next = kNil;
+			--list.size;
+		}
+
+		// ---- LFU 频次桶 ----
+
+		// 把节点放进频次为 freq 的桶；after 为应在其后的桶（kNil 表示从头部开始），桶不存在时紧随 after 新建
+		void attachFreq(uint32_t i, uint64_t freq, uint32_t after)
+		{
+			FreqBucket* buckets = self().buckets();
+			Part& lfu = self().lfuPart();
+			uint32_t b = after == kNil ? lfu.freqHead : buckets[after].next;
+			if (b == kNil || buckets[b].freq != freq) {
+				uint32_t& freeHead = self().freeBucketHead();
+				uint32_t nb = freeHead;
+				freeHead = buckets[nb].next;
+				buckets[nb].freq = freq;
+				buckets[nb].items = List{ kNil, kNil, 0 };
+				buckets[nb].prev = after;
+				buckets[nb].next = b;
+				if (after != kNil) buckets[after].next = nb;
+				else lfu.freqHead = nb;
+				if (b != kNil) buckets[b].prev = nb;
+				else lfu.freqTail = nb;
+				b = nb;
+			}
+			pushBack(buckets[b].items, i);
+			self().nodes()[i].bucket = b;
+		}
+
+		void detachFreq(uint32_t i)
+		{
+			Node& n = self().nodes()[i];
+			uint32_t b = n.bucket;
+			FreqBucket& bucket = self().buckets()[b];
+			unlink(bucket.items, i);
+			n.bucket = kNil;
+			if (bucket.items.size == 0) releaseBucket(b);
+		}
+
+		void releaseBucket(uint32_t b)
+		{
+			FreqBucket* buckets = self().buckets();
+			Part& lfu = self().lfuPart();
+			uint32_t& freeHead = self().freeBucketHead();
+			FreqBucket& bucket = buckets[b];
+			if (bucket.prev != kNil) buckets[bucket.prev].next = bucket.next;
+			else lfu.freqHead = bucket.next;
+			if (bucket.next != kNil) buckets[bucket.next].prev = bucket.prev;
+			else lfu.freqTail = bucket.prev;
+			bucket.next = freeHead;
+			freeHead = b;
+		}
+
+		// 频次加一：旧桶空了也先留在桶链表上，作为新桶的插入位置，挂好后再回收。频次到计数类型上限后只移到桶尾
+		void touchLfu(uint32_t i)
+		{
+			Node& n = self().nodes()[i];
+			FreqBucket* buckets = self().buckets();
+			uint32_t b = n.bucket;
+			unlink(buckets[b].items, i);
+			if (n.accessCount == std::numeric_limits<decltype(n.accessCount)>::max()) {
+				pushBack(buckets[b].items, i);
+				return;
+			}
+			++n.accessCount;
+			attachFreq(i, n.accessCount, b);
+			if (buckets[b].items.size == 0) releaseBucket(b);
+		}
+
+		// ---- 主缓存与幽灵缓存 ----
+
+		bool isLfu(const Part& p) { return &p == &self().lfuPart(); }
+
+		// 从主缓存或幽灵链表上摘下（不动哈希索引）
+		void detach(Part& p, uint32_t i)
+		{
+			uint8_t where = self().nodes()[i].where;
+			if (where == kLruMain) unlink(p.main, i);
+			else if (where == kLfuMain) {
+				detachFreq(i);
+				--p.main.size;
+			}
+			else unlink(p.ghost, i);
+		}
+
+		// 节点已在本部分哈希索引中、不在任何链表上：主缓存满时先逐出，再挂上主缓存
+		void attachMain(Part& p, uint32_t i)
+		{
+			if (p.main.size >= p.capacity) evict(p);
+			Node& n = self().nodes()[i];
+			n.accessCount = 1;
+			if (isLfu(p)) {
+				n.where = kLfuMain;
+				attachFreq(i, 1, kNil);
+				++p.main.size;
+			}
+			else {
+				n.where = kLruMain;
+				pushFront(p.main, i);
+			}
+		}
+
+		// LRU 部分逐出尾部，LFU 部分逐出最小频次桶中最早进入的节点，节点连同值移入本部分幽灵缓存
+		void evict(Part& p)
+		{
+			uint32_t victim;
+			if (isLfu(p)) {
+				if (p.freqHead == kNil) return;
+				victim = self().buckets()[p.freqHead].items.head;
+				detachFreq(victim);
+				--p.main.size;
+			}
+			else {
+				victim = p.main.tail;
+				if (victim == kNil) return;
+				unlink(p.main, victim);
+			}
+			if (p.ghostCapacity == 0) {
+				self().unlinkIndex(p, victim);
+				freeNode(victim);
+				return;
+			}
+			if (p.ghost.size >= p.ghostCapacity) {
+				uint32_t oldest = p.ghost.tail;
+				unlink(p.ghost, oldest);
+				self().unlinkIndex(p, oldest);
+				freeNode(oldest);
+			}
+			Node& n = self().nodes()[victim];
+			n.where = isLfu(p) ? kLfuGhost : kLruGhost;
+			n.accessCount = 1;
+			pushFront(p.ghost, victim);
+		}
+
+		bool decreaseCapacity(Part& p)
+		{
+			if (p.capacity == 0) return false;
+			if (p.main.size == p.capacity) evict(p);
+			--p.capacity;
+			return true;
+		}
+
+		void dropValue(uint32_t i)
+		{
+			Node& n = self().nodes()[i];
+			n.value = Value();
+			n.hasValue = false;
+		}
+
+		// 主缓存查找；LRU 部分访问次数达到阈值时把节点原样移入 LFU 部分（LFU 容量为 0 时不晋升）
+		bool lookup(const Key& key, HashValue h, Value& value)
+		{
+			Node* nodes = self().nodes();
+			Part& lru = self().lruPart();
+			Part& lfu = self().lfuPart();
+			uint32_t i = self().find(lru, key, h);
+			if (i != kNil && nodes[i].where == kLruMain) {
+				value = nodes[i].value;
+				++nodes[i].accessCount;
+				unlink(lru.main, i);
+				pushFront(lru.main, i);
+				if (nodes[i].accessCount >= self().transformThreshold() && lfu.capacity > 0) promote(i);
+				return true;
+			}
+			i = self().find(lfu, key, h);
+			if (i != kNil && nodes[i].where == kLfuMain) {
+				value = nodes[i].value;
+				touchLfu(i);
+				return true;
+			}
+			return false;
+		}
+
+		void promote(uint32_t i)
+		{
+			Node& n = self().nodes()[i];
+			Part& lru = self().lruPart();
+			Part& lfu = self().lfuPart();
+			unlink(lru.main, i);
+			self().unlinkIndex(lru, i);
+			uint32_t g = self().find(lfu, n.key, n.hash);
+			if (g != kNil) { // LFU 幽灵中的同一个键是旧值
+				unlink(lfu.ghost, g);
+				self().unlinkIndex(lfu, g);
+				freeNode(g);
+			}
+			self().linkIndex(lfu, i);
+			attachMain(lfu, i);
+		}
+
+		// 与 ArcCache::checkGhostCaches 相同：幽灵命中的一侧复活该键并从另一侧挪来一个容量；
+		// 已从 LRU 幽灵复活的键不在 LFU 部分再复活一份。返回是否调整了容量
+		bool checkGhosts(const Key& key, HashValue h)
+		{
+			Node* nodes = self().nodes();
+			Part& lru = self().lruPart();
+			Part& lfu = self().lfuPart();
+			bool adjusted = false;
+			bool revived = false;
+			uint32_t i = self().find(lru, key, h);
+			if (i != kNil && nodes[i].where == kLruGhost) {
+				revived = revive(lru, i, true);
+				if (decreaseCapacity(lfu)) {
+					++lru.capacity;
+					adjusted = true;
+				}
+			}
+			i = self().find(lfu, key, h);
+			if (i != kNil && nodes[i].where == kLfuGhost) {
+				revive(lfu, i, !revived);
+				if (decreaseCapacity(lru)) {
+					++lfu.capacity;
+					adjusted = true;
+				}
+			}
+			return adjusted;
+		}
+
+		bool revive(Part& p, uint32_t i, bool allowed)
+		{
+			unlink(p.ghost, i);
+			if (allowed && self().nodes()[i].hasValue && p.capacity > 0) {
+				attachMain(p, i);
+				return true;
+			}
+			self().unlinkIndex(p, i);
+			freeNode(i);
+			return false;
+		}
+	};
+}
@@ -1,25 +1,44 @@
 #pragma once
 #include "KArcCacheNode.h"
+#include "KMemoryUsage.h"
+#include "KArcTagRegistry.h"
+#include "KHashedKey.h"
+#include "KArcReadBuffer.h"
+#include "KArcSnapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include <list>
-#include <mutex>
+#include "KCacheMutex.h"
 namespace KArcCache
 {
-	template<typename Key, typename Value>
+	// 与 LRU 部分相同，接口只接收已带哈希值的键
+	template<typename Key, typename Value, typename KeyEqual = std::equal_to<Key>>
 	class ArcLfuPart {
 	public:
 		using NodeType = ArcNode<Key, Value>;
 		using NodePtr = std::shared_ptr<NodeType>;
-		using NodeMap = std::unordered_map<Key, NodePtr>;
+		using KeyType = HashedKey<Key>;
+		using NodeMap = HashedMap<Key, NodePtr, KeyEqual>;
 		using FreqMap = std::unordered_map<size_t, std::list<NodePtr>>;
+		using Write = std::pair<KeyType, Value>;
 
 
 	private:
-		size_t capacity_;
+		std::atomic<size_t> capacity_; // 同 ArcLruPart
 		size_t ghostCapacity_;
 		size_t transformThreshold_;
 		size_t minFreq_;
-		std::mutex mutex_;
+		CacheSharedMutex mutex_;
+		const ArcTagRegistry* tags_ = nullptr; // 由 ArcCache 设置，为空时不做标签检查
+		std::unique_ptr<ArcReadBuffer<const NodePtr*>> readBuffer_; // 同 ArcLruPart
+		size_t ghostSlack_ = 0;                // 同 ArcLruPart：后台维护时幽灵缓存的裁剪余量
+		uint64_t foregroundEvictions_ = 0;
+		uint64_t exclusiveSections_ = 0;       // 同 ArcLruPart
 
 		NodeMap mainCache_;
 		NodeMap ghostCache_;
@@ -35,77 +54,90 @@ namespace KArcCache
 			ghostTail_->prev_ = ghostHead_;
 		}
 
-        bool updateExistingNode(NodePtr node, const Value& value)
+        bool updateExistingNode(NodePtr node, const Value& value, uint64_t tag, uint64_t generation)
         {
 			node->setValue(value);
+			node->setTag(tag, generation);
 			updateNodeFrequency(node);
 			return true;
         }
 
-        bool addNewNode(const Key& key, const Value& value)
+        bool addNewNode(const KeyType& key, const Value& value, uint64_t tag, uint64_t generation)
         {
 			if (mainCache_.size() >= capacity_) {
+				++foregroundEvictions_;
 				evictLeastFrequent();
 			}
-			NodePtr newNode = std::make_shared<NodeType>(key, value);
+			NodePtr newNode = std::make_shared<NodeType>(key.key, value, key.hash);
 			newNode->accessCount_ = 1;
+			newNode->setTag(tag, generation);
 			//频次初始化与提升不一致，导致同一节点在两个桶里  
 			//如果把新节点丢到 `freqMap_[1]`，但节点自身 `accessCount_` 可能为 0。`updateNodeFrequency` 读到 `oldFreq=0`，会从 `freqMap_[0]` 删（其实没有），
 			// 再把节点又放进 `freqMap_[1]`，于是一个节点在 `freqMap_[1]` 出现两次，随后逐出与遍历容易触发容器断言。
 			mainCache_[key] = newNode;
-			if (freqMap_.find(1) == freqMap_.end()) {
-				freqMap_[1] = std::list<NodePtr>();
-			}
-			freqMap_[1].push_back(newNode);
+			linkToBucket(newNode);
 			minFreq_ = 1;
 			return true;
         }
 
+		// 挂到 accessCount_ 对应频次桶的尾部，并记下位置
+		void linkToBucket(const NodePtr& node)
+		{
+			auto& bucket = freqMap_[node->getAccessCount()];
+			node->freqPos_ = bucket.insert(bucket.end(), node);
+		}
+
+		// 按记下的位置从频次桶摘下，O(1)；返回该桶是否因此变空并被删除
+		bool unlinkFromBucket(const NodePtr& node)
+		{
+			auto it = freqMap_.find(node->getAccessCount());
+			if (it == freqMap_.end()) return false;
+			it->second.erase(node->freqPos_);
+			if (!it->second.empty()) return false;
+			freqMap_.erase(it);
+			return true;
+		}
+
+		size_t lowestFreq() const
+		{
+			size_t m = SIZE_MAX;
+			for (auto& kv : freqMap_) m = std::min(m, kv.first);
+			return (m == SIZE_MAX) ? 0 : m;
+		}
+
+        // 把节点从当前频次桶摘下。最小频次桶被删空时 minFreq_ 置 0（未知），留到下一次逐出时再扫描所有桶；
+        // 多数情况下紧接着写入的新键会把它直接设为 1，扫描就省掉了
+        void removeFromFreqMap(NodePtr node)
+        {
+			size_t oldFreq = node->getAccessCount();
+			if (unlinkFromBucket(node) && minFreq_ == oldFreq) minFreq_ = 0;
+        }
+
+        // 用 splice 把链表节点直接移到下一频次桶的尾部，不重新分配，记下的位置也继续有效
         void updateNodeFrequency(NodePtr node)
         {
 			size_t oldFreq = node->getAccessCount();
-			if (oldFreq) {// 只有存在的桶才尝试移除
-				auto itOld = freqMap_.find(oldFreq);
-				if (itOld != freqMap_.end()) {
-					itOld->second.remove(node);
-					if (itOld->second.empty()) {
-						freqMap_.erase(itOld);
-						if (minFreq_ == oldFreq) {// 重新计算最小频次
-							if (freqMap_.empty()) minFreq_ = 0;
-							else {
-								size_t m = SIZE_MAX;
-								for (auto& kv : freqMap_) m = std::min(m, kv.first);
-								minFreq_ = m;
-							}
-						}
-					}
-				}
-			}
+			auto itOld = freqMap_.find(oldFreq);
+			if (itOld == freqMap_.end()) return;
+			auto& from = itOld->second;
+			auto& to = freqMap_[oldFreq + 1]; // 插入可能重新散列，itOld 失效，但元素的引用仍然有效
+			to.splice(to.end(), from, node->freqPos_);
 			node->increaseAccessCount();
-			size_t newFreq = node->getAccessCount();
-
-			// 添加到新频率列表
-			if (freqMap_.find(newFreq) == freqMap_.end()) {
-				freqMap_[newFreq] = std::list<NodePtr>();
+			// 最小频次桶里最后一个节点升了一级，新的最小频次就是 oldFreq + 1
+			if (from.empty()) {
+				freqMap_.erase(oldFreq);
+				if (minFreq_ == oldFreq) minFreq_ = oldFreq + 1;
 			}
-			freqMap_[newFreq].push_back(node);
-			if (!minFreq_ || newFreq < minFreq_) minFreq_ = newFreq;
         }
 
 		void evictLeastFrequent()
 		{
 			if (freqMap_.empty()) return;
 
-			auto recomputeMin = [&]() -> size_t {
-				size_t m = SIZE_MAX;
-				for (auto& kv : freqMap_) m = std::min(m, kv.first);
-				return (m == SIZE_MAX) ? 0 : m;
-				};
-
 			// 确保 minFreq_ 指向存在且非空的桶
 			auto fit = freqMap_.find(minFreq_);
 			if (minFreq_ == 0 || fit == freqMap_.end() || fit->second.empty()) {
-				minFreq_ = recomputeMin();
+				minFreq_ = lowestFreq();
 				if (minFreq_ == 0) return; // 没有可逐出的桶
 				fit = freqMap_.find(minFreq_);
 				if (fit == freqMap_.end() || fit->second.empty()) return;
@@ -116,19 +148,41 @@ namespace KArcCache
 			NodePtr victim = listRef.back();
 			listRef.pop_back();
 
-			// 桶空则删除，并重新计算 minFreq_
+			// 桶空则删除，minFreq_ 同 removeFromFreqMap 延后计算
 			if (listRef.empty()) {
 				freqMap_.erase(fit);
-				minFreq_ = freqMap_.empty() ? 0 : recomputeMin();
+				minFreq_ = 0;
 			}
 
-			// 从主表删除
+			// 从主表删除，并记入幽灵缓存，使 LFU 幽灵命中能驱动容量自适应；标签已失效的直接回收。
+			// 本部分不向前查找过期节点：高频的过期条目要等下一次查找（惰性删除）或降到最小频次时才腾出槽位
 			if (victim) {
-				mainCache_.erase(victim->getKey());
+				mainCache_.erase(keyOf(victim));
+				if (ghostCapacity_ == 0 || isStale(victim)) {
+					retireGhostLocked(keyOf(victim));
+					return;
+				}
+				if (ghostCache_.size() >= ghostCapacity_ + ghostSlack_) {
+					removeOldestGhost();
+				}
+				addToGhost(victim);
 			}
 		}
 
 
+		static KeyType keyOf(const NodePtr& node) { return { node->getKey(), node->getHash() }; }
+
+		static bool holds(const NodeMap& map, const NodePtr& node)
+		{
+			auto it = map.find(keyOf(node));
+			return it != map.end() && it->second == node;
+		}
+
+		bool isStale(const NodePtr& node) const
+		{
+			return tags_ && tags_->isStale(node->getTag(), node->getGeneration());
+		}
+
         void removeFromGhost(NodePtr node){
 			if (!node->prev_.expired() && node->next_) {
 				auto prev = node->prev_.lock();
@@ -140,21 +194,89 @@ namespace KArcCache
 
         void addToGhost(NodePtr node)
         {
+			auto old = ghostCache_.find(keyOf(node)); // 同 ArcLruPart：先摘掉同键的作废幽灵节点
+			if (old != ghostCache_.end()) {
+				removeFromGhost(old->second);
+				ghostCache_.erase(old);
+			}
 			node->next_ = ghostTail_;
 			node->prev_ = ghostTail_->prev_;
 			if (!ghostTail_->prev_.expired()) {
 				ghostTail_->prev_.lock()->next_ = node;
 			}
 			ghostTail_->prev_ = node;
-			ghostCache_[node->getKey()] = node;
+			ghostCache_[keyOf(node)] = node;
         }
 
+		// 同 ArcLruPart：作废旧值、保留键
+		void retireGhostLocked(const KeyType& key)
+		{
+			auto it = ghostCache_.find(key);
+			if (it != ghostCache_.end()) it->second->dropValue();
+		}
+
+		// 同 ArcLruPart::lockExclusive
+		std::unique_lock<CacheSharedMutex> lockExclusive()
+		{
+			std::unique_lock<CacheSharedMutex> lk(mutex_);
+			++exclusiveSections_;
+			drainReadBuffer();
+			return lk;
+		}
+
+		void drainReadBuffer()
+		{
+			if (readBuffer_) readBuffer_->drain([this](const NodePtr* node) { updateNodeFrequency(*node); });
+		}
+
+		// 同 ArcLruPart::getBuffered：频次桶留到排空时更新
+		bool getBuffered(const KeyType& key, Value& value)
+		{
+			bool full = false;
+			{
+				std::shared_lock<CacheSharedMutex> lk(mutex_);
+				auto it = mainCache_.find(key);
+				if (it == mainCache_.end() || isStale(it->second)) return false;
+				value = it->second->getValue();
+				full = readBuffer_->record(&it->second);
+			}
+			if (full) {
+				std::unique_lock<CacheSharedMutex> lk(mutex_, std::try_to_lock);
+				if (lk.owns_lock()) drainReadBuffer();
+			}
+			return true;
+		}
+
+		// 同 ArcLruPart::clearLocked
+		void clearLocked()
+		{
+			for (NodePtr node = ghostHead_; node;) {
+				NodePtr next = std::move(node->next_);
+				node->next_ = nullptr;
+				node = std::move(next);
+			}
+			mainCache_.clear();
+			ghostCache_.clear();
+			freqMap_.clear();
+			minFreq_ = 0;
+			initializeLists();
+		}
+
+		// 同 ArcLruPart::restoreNode
+		NodePtr restoreNode(const KeyType& key, SnapshotEntry<Key, Value>& e)
+		{
+			NodePtr node = std::make_shared<NodeType>(key.key, std::move(e.value), key.hash);
+			node->setTag(e.tag, tags_ ? tags_->generation(e.tag) : 0);
+			if (!e.hasValue) node->dropValue();
+			return node;
+		}
+
         void removeOldestGhost()
         {
 			NodePtr oldestGhostNode = ghostHead_->next_;
 			if (oldestGhostNode != ghostTail_) {
 				removeFromGhost(oldestGhostNode);
-				ghostCache_.erase(oldestGhostNode->getKey());
+				ghostCache_.erase(keyOf(oldestGhostNode));
 			}
         }
 	public:
@@ -166,25 +288,36 @@ namespace KArcCache
 			initializeLists();
 		}
 
-		void put(Key key, Value value)
+		// tag/generation：条目所属标签及写入时的代际，默认不打标签
+		void put(const KeyType& key, const Value& value, uint64_t tag = 0, uint64_t generation = 0)
 		{
-			if (capacity_ == 0) return;
-			std::lock_guard<std::mutex> lk(mutex_);
+			auto lk = lockExclusive();
 			auto it = mainCache_.find(key);
 			if (it != mainCache_.end()) {
-				updateExistingNode(it->second, value);
+				updateExistingNode(it->second, value, tag, generation);
 				return;
 			}
-			// 未命中：按容量淘汰后新建，频次初始化为 1
-			addNewNode(key, value);
+			// 未命中：按容量淘汰后新建，频次初始化为 1。同 ArcLruPart::put，只有不缓存时才作废幽灵中的旧值
+			if (capacity_ == 0) {
+				retireGhostLocked(key);
+				return;
+			}
+			addNewNode(key, value, tag, generation);
 
 		}
 
-		bool get(Key key, Value& value)
+		bool get(const KeyType& key, Value& value)
 		{
-			std::lock_guard<std::mutex> lk(mutex_);
+			if (readBuffer_) return getBuffered(key, value);
+			auto lk = lockExclusive();
 			auto it = mainCache_.find(key);
 			if (it != mainCache_.end()) {
+				if (isStale(it->second)) { // 标签已失效：惰性删除，按未命中处理
+					removeFromFreqMap(it->second);
+					mainCache_.erase(it);
+					retireGhostLocked(key);
+					return false;
+				}
 				value = it->second->getValue();
 				updateNodeFrequency(it->second);
 				return true;
@@ -192,35 +325,244 @@ namespace KArcCache
 			return false;
 		}
 
-		Value get(Key key) {
+		Value get(const KeyType& key) {
 			Value value;
 			get(key, value);
 			return value;
 		}
 
-		bool contain(Key key)
+		bool contain(const KeyType& key)
 		{
+			std::shared_lock<CacheSharedMutex> lk(mutex_);
 			return mainCache_.find(key) != mainCache_.end();
 		}
 
-		bool checkGhost(Key key)
+		// 批量写入的第一步：整批只加一次锁，更新本部分已有的键（未打标签），其余追加到 missing 交给 LRU 部分
+		void updateBatch(const std::vector<Write>& writes, std::vector<const Write*>& missing)
 		{
-			std::lock_guard<std::mutex> lk(mutex_);
+			auto lk = lockExclusive();
+			for (const Write& w : writes) {
+				auto it = mainCache_.find(w.first);
+				if (it != mainCache_.end()) updateExistingNode(it->second, w.second, ArcTagRegistry::kNoTag, 0);
+				else {
+					retireGhostLocked(w.first); // 同 ArcCache::put：写入 LRU 部分的新键，本部分幽灵中的旧值作废
+					missing.push_back(&w);
+				}
+			}
+		}
+
+		// revive 为 false 时（键已从 LRU 幽灵复活）只报告命中，不再放一份到本部分
+		bool checkGhost(const KeyType& key, bool revive = true)
+		{
+			auto lk = lockExclusive();
 			auto it = ghostCache_.find(key);
 			if (it != ghostCache_.end()) {
 				NodePtr node = it->second;
 				removeFromGhost(it->second);
 				ghostCache_.erase(it);
-				addNewNode(node->getKey(), node->getValue());
+				if (isStale(node)) return false; // 过期的幽灵条目不再复活
+				if (revive && node->hasValue()) {
+					addNewNode(key, node->getValue(), node->getTag(), node->getGeneration());
+				}
 				return true;
 			}
 			return false;
 		}
 
-		void increaseCapacity() { ++capacity_; }
+		// 同 ArcLruPart::retireGhost
+		void retireGhost(const KeyType& key)
+		{
+			auto lk = lockExclusive();
+			retireGhostLocked(key);
+		}
+
+		void increaseCapacity()
+		{
+			auto lk = lockExclusive();
+			++capacity_;
+		}
+
+		// 从主缓存和幽灵缓存中同时删除
+		bool erase(const KeyType& key)
+		{
+			auto lk = lockExclusive();
+			bool erased = false;
+			auto it = mainCache_.find(key);
+			if (it != mainCache_.end()) {
+				removeFromFreqMap(it->second);
+				mainCache_.erase(it);
+				erased = true;
+			}
+			auto git = ghostCache_.find(key);
+			if (git != ghostCache_.end()) {
+				removeFromGhost(git->second);
+				ghostCache_.erase(git);
+			}
+			return erased;
+		}
+
+		void setTagRegistry(const ArcTagRegistry* tags) { tags_ = tags; }
+
+		// 快照格式同 ArcLruPart::snapshot；主缓存条目按频次从低到高、同频次按桶内顺序写入，幽灵条目从最旧到最新
+		void snapshot(SnapshotWriter& out)
+		{
+			std::vector<NodePtr> main;
+			std::vector<NodePtr> ghost;
+			uint64_t copiedAt;
+			{
+				auto lk = lockExclusive();
+				copiedAt = exclusiveSections_;
+				std::vector<size_t> freqs;
+				freqs.reserve(freqMap_.size());
+				for (auto& kv : freqMap_) freqs.push_back(kv.first);
+				std::sort(freqs.begin(), freqs.end());
+				main.reserve(mainCache_.size());
+				ghost.reserve(ghostCache_.size());
+				for (size_t f : freqs) main.insert(main.end(), freqMap_[f].begin(), freqMap_[f].end());
+				for (NodePtr node = ghostHead_->next_; node && node != ghostTail_; node = node->next_) ghost.push_back(node);
+			}
+			auto lock = [this] { return std::shared_lock<CacheSharedMutex>(mutex_); };
+			auto keep = [this, copiedAt](const NodeMap& map, const NodePtr& node) {
+				return (exclusiveSections_ == copiedAt || holds(map, node)) && !isStale(node);
+			};
+			writeSnapshotSection(out, main, false, lock, [&](const NodePtr& node) { return keep(mainCache_, node); });
+			writeSnapshotSection(out, ghost, true, lock, [&](const NodePtr& node) { return keep(ghostCache_, node); });
+		}
+
+		// 同 ArcLruPart::restore；条目多于容量时丢弃频次最低的
+		template<typename HashKeyFn, typename SkipFn>
+		bool restore(SnapshotReader& in, size_t capacity, const HashKeyFn& hashKey, const SkipFn& skip)
+		{
+			auto lk = lockExclusive();
+			clearLocked();
+			capacity_ = capacity;
+			ghostCapacity_ = capacity;
+			SnapshotEntry<Key, Value> e;
+			uint64_t n;
+			if (!in.getU64(n)) return false;
+			uint64_t dropped = n > capacity_ ? n - capacity_ : 0;
+			mainCache_.reserve(static_cast<size_t>(n - dropped));
+			for (uint64_t i = 0; i < n; ++i) {
+				if (!readSnapshotEntry(in, e, false)) return false;
+				KeyType key = hashKey(std::move(e.key));
+				if (i < dropped || skip(key)) continue;
+				NodePtr node = restoreNode(key, e);
+				size_t freq = std::max<size_t>(1, static_cast<size_t>(e.accessCount));
+				node->accessCount_ = freq;
+				mainCache_[key] = node;
+				linkToBucket(node);
+				if (!minFreq_ || freq < minFreq_) minFreq_ = freq;
+			}
+			if (!in.getU64(n)) return false;
+			dropped = n > ghostCapacity_ ? n - ghostCapacity_ : 0;
+			for (uint64_t i = 0; i < n; ++i) {
+				if (!readSnapshotEntry(in, e, true)) return false;
+				if (i < dropped) continue;
+				addToGhost(restoreNode(hashKey(std::move(e.key)), e));
+			}
+			return true;
+		}
+
+		// 清空主缓存与幽灵缓存，容量不变
+		void clear()
+		{
+			auto lk = lockExclusive();
+			clearLocked();
+		}
+
+		// 同 ArcLruPart::setReadBuffer
+		void setReadBuffer(bool enabled)
+		{
+			auto lk = lockExclusive();
+			if (!enabled) readBuffer_.reset();
+			else if (!readBuffer_) readBuffer_ = std::make_unique<ArcReadBuffer<const NodePtr*>>();
+		}
+
+		uint64_t droppedReads() const { return readBuffer_ ? readBuffer_->dropped() : 0; }
+
+		void collectLockStats(std::vector<NamedLockStats>& out, const std::string& name) const
+		{
+			appendLockStats(out, name, mutex_);
+		}
+
+		size_t getCapacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+		// 主缓存中的条目数
+		size_t size()
+		{
+			std::shared_lock<CacheSharedMutex> lk(mutex_);
+			return mainCache_.size();
+		}
+
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize)
+		{
+			namespace est = memory_estimate;
+			auto lk = lockExclusive();
+			MemoryUsage usage;
+			usage.entries = mainCache_.size();
+			usage.index = est::hashTable(mainCache_);
+			// 幽灵链表 2 个哨兵
+			usage.nodes = mainCache_.size() * (est::sharedNode<NodeType>() - sizeof(Value)) + 2 * est::sharedNode<NodeType>();
+			usage.ghost = est::hashTable(ghostCache_) + ghostCache_.size() * est::sharedNode<NodeType>();
+			usage.freqBuckets = est::hashTable(freqMap_);
+			for (auto& kv : freqMap_) usage.freqBuckets += kv.second.size() * est::listNode<NodePtr>();
+			usage.values = mainCache_.size() * sizeof(Value);
+			usage.exact = static_cast<bool>(valueSize);
+			if (valueSize) {
+				for (auto& kv : mainCache_) usage.values += valueSize(kv.second->getValue());
+				for (auto& kv : ghostCache_) usage.ghost += valueSize(kv.second->getValue());
+			}
+			return usage;
+		}
+
+		// 只修改容量上限（幽灵缓存同步），不立即逐出；超出部分由 evictExcess 分批回收
+		void setCapacity(size_t capacity)
+		{
+			auto lk = lockExclusive();
+			capacity_ = capacity;
+			ghostCapacity_ = capacity;
+		}
+
+		// 最多逐出 budget 个主缓存/幽灵节点，返回 true 表示已回到上限以内；headroom 含义同 ArcLruPart
+		bool evictExcess(size_t budget, size_t headroom = 0)
+		{
+			auto lk = lockExclusive();
+			size_t capacity = capacity_;
+			size_t target = capacity - std::min(headroom, capacity);
+			while (budget > 0 && mainCache_.size() > target) {
+				evictLeastFrequent();
+				--budget;
+			}
+			while (budget > 0 && ghostCache_.size() > ghostCapacity_) {
+				removeOldestGhost();
+				--budget;
+			}
+			return mainCache_.size() <= target && ghostCache_.size() <= ghostCapacity_;
+		}
+
+		// 同 ArcLruPart::hasHeadroom
+		bool hasHeadroom(size_t headroom)
+		{
+			std::shared_lock<CacheSharedMutex> lk(mutex_);
+			size_t capacity = capacity_;
+			return mainCache_.size() + std::min(headroom, capacity) <= capacity && ghostCache_.size() <= ghostCapacity_;
+		}
+
+		void setGhostSlack(size_t slack)
+		{
+			auto lk = lockExclusive();
+			ghostSlack_ = slack;
+		}
+
+		uint64_t foregroundEvictions()
+		{
+			std::shared_lock<CacheSharedMutex> lk(mutex_);
+			return foregroundEvictions_;
+		}
 
 		bool decreaseCapacity()
 		{
+			auto lk = lockExclusive();
 			if (capacity_ <= 0) return false;
 			if (mainCache_.size() == capacity_)
 			{
@@ -1,21 +1,41 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
 #include <unordered_map>
-#include <mutex>
+#include <utility>
+#include <vector>
+#include "KCacheMutex.h"
 #include "KArcCacheNode.h"
+#include "KMemoryUsage.h"
+#include "KArcTagRegistry.h"
+#include "KHashedKey.h"
+#include "KArcReadBuffer.h"
+#include "KArcSnapshot.h"
 namespace KArcCache {
 
-	template<typename Key, typename Value>
+	// 所有接口都接收已带哈希值的键，本部分从不调用哈希函数
+	template<typename Key, typename Value, typename KeyEqual = std::equal_to<Key>>
 	class ArcLruPart  {
 	public:
 		using NodeType = ArcNode<Key, Value>;
 		using NodePtr = std::shared_ptr<NodeType>;
-		using NodeMap = std::unordered_map<Key, NodePtr>;
+		using KeyType = HashedKey<Key>;
+		using NodeMap = HashedMap<Key, NodePtr, KeyEqual>;
+		using Write = std::pair<KeyType, Value>;
 
 	private:
-		size_t capacity_;
+		std::atomic<size_t> capacity_; // 在锁内修改；getCapacity 在锁外读取（ArcCache 调整容量划分时）
 		size_t ghostCapacity_;
 		size_t transformThreshold_;
-		std::mutex mutex_;
+		CacheSharedMutex mutex_;
+		const ArcTagRegistry* tags_ = nullptr; // 由 ArcCache 设置，为空时不做标签检查
+		std::unique_ptr<ArcReadBuffer<const NodePtr*>> readBuffer_; // 可选：命中只加共享锁，访问记入读缓冲
+		size_t ghostSlack_ = 0;                // 开启后台维护时幽灵缓存可暂时超出的条数，超出部分由 evictExcess 成批裁剪
+		uint64_t foregroundEvictions_ = 0;     // 写入/幽灵复活时因主缓存已满而同步逐出的次数
+		size_t staleScan_ = kMinStaleScan;     // 当前的过期节点查找步数，见 reclaimStaleNearTail
+		uint64_t exclusiveSections_ = 0;       // lockExclusive 的次数；没有变化说明两表的成员都没变，快照分批编码时据此省去逐个查表
 
 
 		NodeMap mainCache_;
@@ -42,21 +62,26 @@ namespace KArcCache {
 			ghostTail_->prev_ = ghostHead_;
 		}
 
-		bool updateExistingNode(NodePtr node, const Value& value)
+		bool updateExistingNode(NodePtr node, const Value& value, uint64_t tag, uint64_t generation)
 		{
 			node->setValue(value);
+			node->setTag(tag, generation);
 			moveToFront(node);
 			return true;
 		}
 
-		bool addNewNode(const Key& key, const Value& value)
+		// atTail 为 true 时插在链表尾部，下一次淘汰最先被逐出（扫描流量）
+		bool addNewNode(const KeyType& key, const Value& value, uint64_t tag, uint64_t generation, bool atTail = false)
 		{
 			if (mainCache_.size() >= capacity_) {
+				++foregroundEvictions_;
 				evictLeastRecent();
 			}
-			NodePtr newNode = std::make_shared<NodeType>(key, value);
+			NodePtr newNode = std::make_shared<NodeType>(key.key, value, key.hash);
+			newNode->setTag(tag, generation);
 			mainCache_[key] = newNode;
-			addToFront(newNode);
+			if (atTail) addToBack(newNode);
+			else addToFront(newNode);
 			return true;
 		}
 
@@ -87,19 +112,63 @@ namespace KArcCache {
 			mainHead_->next_ = node;
 		}
 
+		static KeyType keyOf(const NodePtr& node) { return { node->getKey(), node->getHash() }; }
+
+		static bool holds(const NodeMap& map, const NodePtr& node)
+		{
+			auto it = map.find(keyOf(node));
+			return it != map.end() && it->second == node;
+		}
+
+		void addToBack(NodePtr node)
+		{
+			NodePtr last = mainTail_->prev_.lock();
+			node->next_ = mainTail_;
+			node->prev_ = last;
+			last->next_ = node;
+			mainTail_->prev_ = node;
+		}
+
+		bool isStale(const NodePtr& node) const
+		{
+			return tags_ && tags_->isStale(node->getTag(), node->getGeneration());
+		}
+
+		// 淘汰时先在尾部附近找已过期（标签失效）的节点，找到就直接回收，不进入幽灵缓存。
+		// 查找步数自适应：找到就加倍（批量失效后过期节点很多，向前多看几个），找不到就减半，回到 kMinStaleScan。
+		// 更靠前的过期节点要等它没被访问、自然漂到尾部附近才回收，在此之前仍占着槽位
+		bool reclaimStaleNearTail()
+		{
+			if (!tags_) return false;
+			NodePtr node = mainTail_->prev_.lock();
+			for (size_t i = 0; i < staleScan_ && node && node != mainHead_; ++i) {
+				if (isStale(node)) {
+					removeFromMain(node);
+					mainCache_.erase(keyOf(node));
+					retireGhostLocked(keyOf(node));
+					staleScan_ = staleScan_ * 2 < kMaxStaleScan ? staleScan_ * 2 : kMaxStaleScan;
+					return true;
+				}
+				node = node->prev_.lock();
+			}
+			staleScan_ = staleScan_ / 2 > kMinStaleScan ? staleScan_ / 2 : kMinStaleScan;
+			return false;
+		}
+
 		void evictLeastRecent()
 		{
+			if (reclaimStaleNearTail()) return;
 			NodePtr leastRecentNode = mainTail_->prev_.lock();
 			if (!leastRecentNode || leastRecentNode == mainHead_) return;
 			//从主链表移除
 			removeFromMain(leastRecentNode);
 			//添加到幽灵缓存
-			if (ghostCache_.size() >= ghostCapacity_) {
+			if (ghostCache_.size() >= ghostCapacity_ + ghostSlack_) {
 				removeOldestGhost();
 			}
 			addToGhost(leastRecentNode);
 			//从主缓存映射中移除
-			mainCache_.erase(leastRecentNode->getKey());
+			mainCache_.erase(keyOf(leastRecentNode));
 		}
 
 		void removeFromMain(NodePtr node)
@@ -124,6 +193,12 @@ namespace KArcCache {
 
 		void addToGhost(NodePtr node)
 		{
+			// 同一个键已有（作废的）幽灵节点时先摘掉，链表里不留映射找不到的节点
+			auto old = ghostCache_.find(keyOf(node));
+			if (old != ghostCache_.end()) {
+				removeFromGhost(old->second);
+				ghostCache_.erase(old);
+			}
 			// 重置节点的访问计数
 			node->accessCount_ = 1;
 
@@ -134,7 +209,7 @@ namespace KArcCache {
 			ghostHead_->next_ = node;
 
 			//添加到幽灵缓存映射
-			ghostCache_[node->getKey()] = node;
+			ghostCache_[keyOf(node)] = node;
 		}
 
 		void removeOldestGhost()
@@ -142,9 +217,85 @@ namespace KArcCache {
 			NodePtr oldestGhostNode = ghostTail_->prev_.lock();
 			if (!oldestGhostNode || oldestGhostNode == ghostHead_) return;
 			removeFromGhost(oldestGhostNode);
-			ghostCache_.erase(oldestGhostNode->getKey());
+			ghostCache_.erase(keyOf(oldestGhostNode));
 		}
 
+		// 键不经逐出离开主缓存（晋升、过期回收）或被写入别处时，幽灵里同一个键保存的是旧值，日后幽灵命中会把旧值复活。
+		// 只作废值、保留键：幽灵命中仍驱动容量自适应，但不再复活
+		void retireGhostLocked(const KeyType& key)
+		{
+			auto it = ghostCache_.find(key);
+			if (it != ghostCache_.end()) it->second->dropValue();
+		}
+
+		// 独占加锁并先回放读缓冲。缓冲里的指针指向主表中的元素，只在下一次独占加锁前有效，
+		// 所以任何改动主表或链表的操作都必须经由这里加锁
+		std::unique_lock<CacheSharedMutex> lockExclusive()
+		{
+			std::unique_lock<CacheSharedMutex> lock(mutex_);
+			++exclusiveSections_;
+			drainReadBuffer();
+			return lock;
+		}
+
+		void drainReadBuffer()
+		{
+			if (readBuffer_) readBuffer_->drain([this](const NodePtr* node) { updateNodeAccess(*node); });
+		}
+
+		// 读缓冲版本的命中路径：共享锁下查表、取值并记录访问，链表顺序留到排空时更新。
+		// 过期节点在共享锁下不能删除，按未命中处理，留给淘汰时回收
+		bool getBuffered(const KeyType& key, Value& value, bool& shouldTransform)
+		{
+			bool full = false;
+			{
+				std::shared_lock<CacheSharedMutex> lock(mutex_);
+				auto it = mainCache_.find(key);
+				if (it == mainCache_.end() || isStale(it->second)) return false;
+				value = it->second->getValue();
+				// 尚未回放的访问不计入访问次数，晋升可能推迟到下一次排空之后
+				shouldTransform = it->second->getAccessCount() + 1 >= transformThreshold_;
+				full = readBuffer_->record(&it->second);
+			}
+			if (full) {
+				std::unique_lock<CacheSharedMutex> lock(mutex_, std::try_to_lock);
+				if (lock.owns_lock()) drainReadBuffer();
+			}
+			return true;
+		}
+
+		// 先逐个断开 next_ 再清空映射：直接丢掉链表头会沿 shared_ptr 链递归析构，长链表会栈溢出
+		void clearLocked()
+		{
+			unlinkAll(mainHead_);
+			unlinkAll(ghostHead_);
+			mainCache_.clear();
+			ghostCache_.clear();
+			initializeLists();
+		}
+
+		static void unlinkAll(NodePtr node)
+		{
+			while (node) {
+				NodePtr next = std::move(node->next_);
+				node->next_ = nullptr;
+				node = std::move(next);
+			}
+		}
+
+		// 快照中的标签按当前代际恢复
+		NodePtr restoreNode(const KeyType& key, SnapshotEntry<Key, Value>& e)
+		{
+			NodePtr node = std::make_shared<NodeType>(key.key, std::move(e.value), key.hash);
+			node->setTag(e.tag, tags_ ? tags_->generation(e.tag) : 0);
+			if (!e.hasValue) node->dropValue();
+			return node;
+		}
+
+		// 淘汰时向前查找过期节点的步数范围
+		static constexpr size_t kMinStaleScan = 4;
+		static constexpr size_t kMaxStaleScan = 256;
+
 	public:
 		explicit ArcLruPart(size_t capacity,size_t transformThreshold):
 			capacity_(capacity),
@@ -153,49 +304,112 @@ namespace KArcCache {
 			initializeLists();
 		}
 
-		bool get(Key key, Value& value) {
-			std::lock_guard<std::mutex> lock(mutex_);
+		bool get(const KeyType& key, Value& value) {
+			bool shouldTransform = false;
+			return get(key, value, shouldTransform);
+		}
+		// 命中后访问次数达到 transformThreshold_ 时 shouldTransform 置 true，由 ArcCache 晋升到 LFU 部分
+		bool get(const KeyType& key, Value& value, bool& shouldTransform) {
+			if (readBuffer_) return getBuffered(key, value, shouldTransform);
+			auto lock = lockExclusive();
 			auto it = mainCache_.find(key);
 			if (it != mainCache_.end()) {
+				if (isStale(it->second)) { // 标签已失效：惰性删除，按未命中处理
+					removeFromMain(it->second);
+					mainCache_.erase(it);
+					retireGhostLocked(key);
+					return false;
+				}
 				value = it->second->getValue();
 				updateNodeAccess(it->second);
+				shouldTransform = it->second->getAccessCount() >= transformThreshold_;
 				return true;
 			}
 			return false;
 		}
-		Value get(Key key) {
+		Value get(const KeyType& key) {
 			Value value;
 			get(key, value);
 			return value;
 		}
-		void put(Key key, Value value) {
-			if (capacity_ == 0) return;
-			std::lock_guard<std::mutex> lock(mutex_);
+		// tag/generation：条目所属标签及写入时的代际，默认不打标签
+		void put(const KeyType& key, const Value& value, uint64_t tag = 0, uint64_t generation = 0) {
+			auto lock = lockExclusive();
 			// 命中：只更新值，不动链表、不动 ghost
 			auto it = mainCache_.find(key);
 			if (it != mainCache_.end()) {
-				updateExistingNode(it->second, value);
+				updateExistingNode(it->second, value, tag, generation);
 				return;                                  // 关键：命中早退
 			}
-			// 未命中：必要时淘汰旧节点，再新建
-			addNewNode(key, value);
+			// 未命中：必要时淘汰旧节点，再新建。本部分幽灵里的同一个键会在节点被逐出时整个替换掉，无需处理；
+			// 容量被自适应压到 0 时不缓存，幽灵中的旧值就必须作废
+			if (capacity_ == 0) {
+				retireGhostLocked(key);
+				return;
+			}
+			addNewNode(key, value, tag, generation);
+		}
+
+		// 扫描检测到的新键：插在 LRU 尾部，扫描键之间互相替换，不再挤出工作集；已存在的键按普通 put 处理
+		void putAtTail(const KeyType& key, const Value& value, uint64_t tag = 0, uint64_t generation = 0) {
+			auto lock = lockExclusive();
+			auto it = mainCache_.find(key);
+			if (it != mainCache_.end()) {
+				updateExistingNode(it->second, value, tag, generation);
+				return;
+			}
+			if (capacity_ == 0) {
+				retireGhostLocked(key);
+				return;
+			}
+			addNewNode(key, value, tag, generation, true);
 		}
 
-		bool checkGhost(Key key) {
+		// 批量写入（未打标签）：整批只加一次锁，已存在的更新、新键按 put 的方式插入
+		void putBatch(const std::vector<const Write*>& writes) {
+			if (writes.empty()) return;
+			auto lock = lockExclusive();
+			for (const Write* w : writes) {
+				auto it = mainCache_.find(w->first);
+				if (it != mainCache_.end()) updateExistingNode(it->second, w->second, ArcTagRegistry::kNoTag, 0);
+				else if (capacity_ > 0) addNewNode(w->first, w->second, ArcTagRegistry::kNoTag, 0);
+				else retireGhostLocked(w->first);
+			}
+		}
+
+		// 幽灵命中返回 true；值已作废的条目只报告命中，不复活，revived 告知调用方是否放回了主缓存
+		bool checkGhost(const KeyType& key, bool* revived = nullptr) {
+			auto lock = lockExclusive();
+			if (revived) *revived = false;
 			auto it = ghostCache_.find(key);
 			if (it != ghostCache_.end()) {
 				NodePtr node = it->second;
 				removeFromGhost(it->second);
 				ghostCache_.erase(it);
-				addNewNode(node->getKey(), node->getValue());
+				if (isStale(node)) return false; // 过期的幽灵条目不再复活
+				if (node->hasValue()) {
+					addNewNode(key, node->getValue(), node->getTag(), node->getGeneration());
+					if (revived) *revived = true;
+				}
 				return true;
 			}
 			return false;
 		}
 
-		void increaseCapacity() { capacity_++; }
+		// 键被写入另一部分（或按扫描旁路不缓存）时，作废本部分幽灵缓存中的旧值
+		void retireGhost(const KeyType& key)
+		{
+			auto lock = lockExclusive();
+			retireGhostLocked(key);
+		}
+
+		void increaseCapacity() {
+			auto lock = lockExclusive();
+			capacity_++;
+		}
 
 		bool decreaseCapacity() {
+			auto lock = lockExclusive();
 			if (capacity_ <= 0)return false;
 			if (mainCache_.size() == capacity_) {
 				evictLeastRecent();
@@ -204,9 +418,204 @@ namespace KArcCache {
 			return true;
 		}
 
-		bool contain(Key key)
+		bool contain(const KeyType& key)
 		{
+			std::shared_lock<CacheSharedMutex> lock(mutex_);
 			return mainCache_.find(key) != mainCache_.end();
 		}
+
+		// 直接移出主缓存并返回该节点，不进入幽灵缓存（晋升到 LFU 时使用）。
+		// 之后的写入落在 LFU 部分，本部分幽灵里残留的同一个键不会再被替换，作废其中的旧值
+		NodePtr take(const KeyType& key)
+		{
+			auto lock = lockExclusive();
+			auto it = mainCache_.find(key);
+			if (it == mainCache_.end()) return nullptr;
+			NodePtr node = it->second;
+			removeFromMain(node);
+			mainCache_.erase(it);
+			retireGhostLocked(key);
+			return node;
+		}
+
+		// 从主缓存和幽灵缓存中同时删除
+		bool erase(const KeyType& key)
+		{
+			auto lock = lockExclusive();
+			bool erased = false;
+			auto it = mainCache_.find(key);
+			if (it != mainCache_.end()) {
+				removeFromMain(it->second);
+				mainCache_.erase(it);
+				erased = true;
+			}
+			auto git = ghostCache_.find(key);
+			if (git != ghostCache_.end()) {
+				removeFromGhost(git->second);
+				ghostCache_.erase(git);
+			}
+			return erased;
+		}
+
+		void setTagRegistry(const ArcTagRegistry* tags) { tags_ = tags; }
+
+		// 快照格式：主缓存条目数与条目（从最久未用到最近使用），幽灵条目数与条目（从最旧到最新）。
+		// 独占锁下只按顺序拷出节点指针，编码在共享锁下分批进行（见 writeSnapshotSection），
+		// 拷出之后被逐出、删除或标签失效的条目不写入，之后写入的新键不在快照中
+		void snapshot(SnapshotWriter& out)
+		{
+			std::vector<NodePtr> main;
+			std::vector<NodePtr> ghost;
+			uint64_t copiedAt;
+			{
+				auto lock = lockExclusive();
+				copiedAt = exclusiveSections_;
+				main.reserve(mainCache_.size());
+				ghost.reserve(ghostCache_.size());
+				for (NodePtr node = mainTail_->prev_.lock(); node && node != mainHead_; node = node->prev_.lock()) main.push_back(node);
+				for (NodePtr node = ghostTail_->prev_.lock(); node && node != ghostHead_; node = node->prev_.lock()) ghost.push_back(node);
+			}
+			auto lock = [this] { return std::shared_lock<CacheSharedMutex>(mutex_); };
+			auto keep = [this, copiedAt](const NodeMap& map, const NodePtr& node) {
+				return (exclusiveSections_ == copiedAt || holds(map, node)) && !isStale(node);
+			};
+			writeSnapshotSection(out, main, false, lock, [&](const NodePtr& node) { return keep(mainCache_, node); });
+			writeSnapshotSection(out, ghost, true, lock, [&](const NodePtr& node) { return keep(ghostCache_, node); });
+		}
+
+		// 丢弃现有内容并按快照重建，容量设为 capacity。条目多于容量时丢弃最旧的；skip 返回 true 的键
+		// （已在 LFU 部分恢复）跳过。hashKey 把键转成 KeyType。返回 false 表示快照数据不完整
+		template<typename HashKeyFn, typename SkipFn>
+		bool restore(SnapshotReader& in, size_t capacity, const HashKeyFn& hashKey, const SkipFn& skip)
+		{
+			auto lock = lockExclusive();
+			clearLocked();
+			capacity_ = capacity;
+			ghostCapacity_ = capacity;
+			SnapshotEntry<Key, Value> e;
+			uint64_t n;
+			if (!in.getU64(n)) return false;
+			uint64_t dropped = n > capacity_ ? n - capacity_ : 0;
+			mainCache_.reserve(static_cast<size_t>(n - dropped));
+			for (uint64_t i = 0; i < n; ++i) {
+				if (!readSnapshotEntry(in, e, false)) return false;
+				KeyType key = hashKey(std::move(e.key));
+				if (i < dropped || skip(key)) continue;
+				NodePtr node = restoreNode(key, e);
+				node->accessCount_ = static_cast<size_t>(e.accessCount);
+				mainCache_[key] = node;
+				addToFront(node);
+			}
+			if (!in.getU64(n)) return false;
+			dropped = n > ghostCapacity_ ? n - ghostCapacity_ : 0;
+			for (uint64_t i = 0; i < n; ++i) {
+				if (!readSnapshotEntry(in, e, true)) return false;
+				if (i < dropped) continue;
+				addToGhost(restoreNode(hashKey(std::move(e.key)), e));
+			}
+			return true;
+		}
+
+		// 清空主缓存与幽灵缓存，容量不变
+		void clear()
+		{
+			auto lock = lockExclusive();
+			clearLocked();
+		}
+
+		// 开关读缓冲；关闭前先回放缓冲中的访问。需在并发访问开始前调用
+		void setReadBuffer(bool enabled)
+		{
+			auto lock = lockExclusive();
+			if (!enabled) readBuffer_.reset();
+			else if (!readBuffer_) readBuffer_ = std::make_unique<ArcReadBuffer<const NodePtr*>>();
+		}
+
+		uint64_t droppedReads() const { return readBuffer_ ? readBuffer_->dropped() : 0; }
+
+		void collectLockStats(std::vector<NamedLockStats>& out, const std::string& name) const
+		{
+			appendLockStats(out, name, mutex_);
+		}
+
+		size_t getCapacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+		// 主缓存中的条目数
+		size_t size()
+		{
+			std::shared_lock<CacheSharedMutex> lock(mutex_);
+			return mainCache_.size();
+		}
+
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize)
+		{
+			namespace est = memory_estimate;
+			auto lock = lockExclusive();
+			MemoryUsage usage;
+			usage.entries = mainCache_.size();
+			usage.index = est::hashTable(mainCache_);
+			// 主链表与幽灵链表共 4 个哨兵
+			usage.nodes = mainCache_.size() * (est::sharedNode<NodeType>() - sizeof(Value)) + 4 * est::sharedNode<NodeType>();
+			usage.ghost = est::hashTable(ghostCache_) + ghostCache_.size() * est::sharedNode<NodeType>();
+			usage.values = mainCache_.size() * sizeof(Value);
+			usage.exact = static_cast<bool>(valueSize);
+			if (valueSize) {
+				for (auto& kv : mainCache_) usage.values += valueSize(kv.second->getValue());
+				for (auto& kv : ghostCache_) usage.ghost += valueSize(kv.second->getValue());
+			}
+			return usage;
+		}
+
+		// 只修改容量上限（幽灵缓存同步），不立即逐出；超出部分由 evictExcess 分批回收
+		void setCapacity(size_t capacity)
+		{
+			auto lock = lockExclusive();
+			capacity_ = capacity;
+			ghostCapacity_ = capacity;
+		}
+
+		// 最多逐出 budget 个主缓存/幽灵节点，返回 true 表示已回到上限以内。
+		// headroom 非 0 时（后台维护）把主缓存压到 capacity - headroom，为之后的写入预留空槽
+		bool evictExcess(size_t budget, size_t headroom = 0)
+		{
+			auto lock = lockExclusive();
+			size_t capacity = capacity_;
+			size_t target = capacity - std::min(headroom, capacity);
+			while (budget > 0 && mainCache_.size() > target) {
+				evictLeastRecent();
+				--budget;
+			}
+			while (budget > 0 && ghostCache_.size() > ghostCapacity_) {
+				removeOldestGhost();
+				--budget;
+			}
+			return mainCache_.size() <= target && ghostCache_.size() <= ghostCapacity_;
+		}
+
+		// 主缓存已压到 capacity - headroom 以内、幽灵缓存也未超限，evictExcess 无事可做
+		bool hasHeadroom(size_t headroom)
+		{
+			std::shared_lock<CacheSharedMutex> lock(mutex_);
+			size_t capacity = capacity_;
+			return mainCache_.size() + std::min(headroom, capacity) <= capacity && ghostCache_.size() <= ghostCapacity_;
+		}
+
+		void setGhostSlack(size_t slack)
+		{
+			auto lock = lockExclusive();
+			ghostSlack_ = slack;
+		}
+
+		uint64_t foregroundEvictions()
+		{
+			std::shared_lock<CacheSharedMutex> lock(mutex_);
+			return foregroundEvictions_;
+		}
+
+		void setTransformThreshold(size_t transformThreshold)
+		{
+			auto lock = lockExclusive();
+			transformThreshold_ = transformThreshold;
+		}
 	};
 }
\ No newline at end of file
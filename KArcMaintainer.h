@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace KArcCache {
+
+	// 后台维护线程：被 notify 唤醒或空等 interval 后反复执行 task，直到 task 返回 true（本轮已无事可做）。
+	// notify 只在 pending_ 由 false 变为 true 时加一次锁并调用 notify_one，其余时候写入路径上的开销是一次原子交换。
+	// 唤醒不会丢失，interval 只是兜底，可以设得很长
+	class ArcMaintainer {
+	public:
+		ArcMaintainer(std::function<bool()> task, std::chrono::milliseconds interval) :
+			task_(std::move(task)),
+			interval_(interval),
+			runs_(0),
+			stop_(false),
+			pending_(false),
+			thread_([this] { loop(); }) {}
+
+		~ArcMaintainer()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+			cv_.notify_one();
+			thread_.join();
+		}
+
+		ArcMaintainer(const ArcMaintainer&) = delete;
+		ArcMaintainer& operator=(const ArcMaintainer&) = delete;
+
+		void notify()
+		{
+			if (pending_.exchange(true, std::memory_order_acq_rel)) return;
+			// 空加一次锁：等待方要么在检查 pending_ 之前，要么已经睡下，notify_one 不会落空
+			{ std::lock_guard<std::mutex> lock(mutex_); }
+			cv_.notify_one();
+		}
+
+		// task 被执行的总次数
+		uint64_t runs() const { return runs_.load(std::memory_order_relaxed); }
+
+	private:
+		void loop()
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			while (!stop_) {
+				cv_.wait_for(lock, interval_, [this] { return stop_ || pending_.load(std::memory_order_acquire); });
+				if (stop_) break;
+				pending_.store(false, std::memory_order_release);
+				lock.unlock();
+				bool done = false;
+				while (!done && !stop_.load(std::memory_order_relaxed)) {
+					done = task_();
+					runs_.fetch_add(1, std::memory_order_relaxed);
+				}
+				lock.lock();
+			}
+		}
+
+		std::function<bool()> task_;
+		std::chrono::milliseconds interval_;
+		std::atomic<uint64_t> runs_;
+		std::atomic<bool> stop_; // 在 mutex_ 下置位，保证等待中的线程不会错过
+		std::atomic<bool> pending_;
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		std::thread thread_; // 最后构造：线程启动时其余成员都已就绪
+	};
+}
@@ -0,0 +1,237 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "KArcSampler.h"
+#include "KCacheMutex.h"
+
+namespace KArcCache {
+
+	struct MrcPoint {
+		size_t capacity;
+		double hitRatio;
+	};
+
+	// 在线缺失率曲线（MRC）估计：SHARDS 采样 + 重用距离直方图。
+	// 重用距离 d 表示两次访问同一键之间出现过的不同键个数，容量为 C 的 LRU 在 d < C 时命中，
+	// 所以直方图的前缀和就是各容量下的命中率估计。
+	// 读未命中不回填时，容量 C 的 LRU 只在 d < C 时把读到的键移到栈顶，单一的栈无法同时代表所有容量：
+	// 这里按 maxCapacity、maxCapacity/2、maxCapacity/4……各维护一个栈（锚点），每个栈只在自己的锚点上精确，
+	// 估计容量 C 时取夹住 C 的两个锚点的栈各自在 C 处的估计，按 log C 线性插值。调用方未命中后回填时各栈一致，所有容量都精确。
+	// 采样率有下限：容量 maxCapacity 的 LRU 栈按采样率缩小后至少还有 kMinSampledStack 个键，
+	// 否则小缓存的距离被离散到 0、1、2 几档，命中率严重低估（容量 20、采样率 0.1 时栈里只剩约 2 个键）。
+	// 内存有界：最多跟踪 maxSamples 个采样键，超出时按 SHARDS 固定样本数做法降低采样阈值。
+	template<typename Key>
+	class ArcMrcEstimator {
+	public:
+		explicit ArcMrcEstimator(size_t maxCapacity, double sampleRate = 0.001,
+			size_t maxSamples = 8192, size_t curvePoints = 64) :
+			sampler_(minimumRate(sampleRate, maxCapacity)),
+			maxSamples_(std::max<size_t>(maxSamples, 1)),
+			bucketWidth_(std::max<size_t>(maxCapacity / std::max<size_t>(curvePoints, 1), 1)),
+			sampledGets_(0)
+		{
+			size_t buckets = maxCapacity / bucketWidth_ + 1;
+			double anchor = static_cast<double>(std::max<size_t>(maxCapacity, 1));
+			do {
+				stacks_.emplace_back(anchor, buckets, maxSamples_);
+				anchor /= 2;
+			} while (stacks_.size() < kMaxStacks && anchor >= bucketWidth_);
+		}
+
+		// 与缓存语义一致：put 把键压入栈顶；get 计入命中率，栈中已有且距离小于栈的锚点时移到栈顶
+		void access(const Key& key, bool isGet)
+		{
+			accessHashed(sampleHash(key), isGet);
+		}
+
+		// h 为已经过 mixHash 混合的键哈希，调用方已有哈希值时省去一次重算
+		void accessHashed(uint64_t h, bool isGet)
+		{
+			if (!sampler_.sampled(h)) return; // 未采样：只有一次哈希和比较的开销
+
+			std::lock_guard<CacheMutex> lock(mutex_);
+			if (!sampler_.sampled(h)) return; // 加锁期间阈值可能已被调低
+
+			// 各栈跟踪同一组键，共用一张键到槽位的表：键只在写入时进栈，读从未写入过的键不会把它放进缓存
+			if (isGet) ++sampledGets_;
+			auto it = slots_.find(h);
+			bool tracked = it != slots_.end();
+			if (!tracked) {
+				if (isGet) return;
+				bySampleValue_.emplace(sampler_.sampleValue(h), h);
+				it = slots_.emplace(h, allocateSlot()).first;
+			}
+			for (auto& s : stacks_) touch(s, it->second, isGet, tracked);
+
+			if (bySampleValue_.size() > maxSamples_) shrinkSample();
+		}
+
+		// 估计容量为 capacity 时的命中率（基于 LRU 栈距离）
+		double estimateHitRatio(size_t capacity)
+		{
+			std::lock_guard<CacheMutex> lock(mutex_);
+			return estimate(capacity);
+		}
+
+		// 从 bucketWidth 到 maxCapacity 每个刻度一个点
+		std::vector<MrcPoint> hitRatioCurve()
+		{
+			std::lock_guard<CacheMutex> lock(mutex_);
+			std::vector<MrcPoint> curve;
+			size_t points = stacks_[0].histogram.size() - 1;
+			curve.reserve(points);
+			for (size_t i = 0; i < points; ++i) {
+				size_t capacity = (i + 1) * bucketWidth_;
+				curve.push_back({ capacity, estimate(capacity) });
+			}
+			return curve;
+		}
+
+		uint64_t sampledGets()
+		{
+			std::lock_guard<CacheMutex> lock(mutex_);
+			return sampledGets_;
+		}
+
+		double sampleRate() const { return sampler_.rate(); }
+
+		void collectLockStats(std::vector<NamedLockStats>& out, const std::string& name) const
+		{
+			appendLockStats(out, name, mutex_);
+		}
+
+	private:
+		static constexpr size_t kMinSampledStack = 256;
+		static constexpr size_t kMaxStacks = 8;
+
+		// 一个锚点的 LRU 栈：树状数组上时间戳 t 标 1 表示某个键最近一次进栈顶发生在 t
+		struct Stack {
+			Stack(double anchor, size_t buckets, size_t maxSamples) :
+				anchor(anchor), histogram(buckets, 0), tree(2 * maxSamples + 1, 0) {}
+
+			double anchor;                    // 读请求的（放大后）距离小于它才移到栈顶
+			std::vector<uint64_t> histogram;  // 最后一个桶之外的距离不计入
+			uint64_t clock = 0;
+			uint64_t marked = 0;
+			std::vector<int64_t> tree;
+			std::vector<uint64_t> lastAccess; // 按槽位：键最近进栈顶的时间戳
+		};
+
+		static double minimumRate(double rate, size_t maxCapacity)
+		{
+			double floor = maxCapacity > kMinSampledStack ? static_cast<double>(kMinSampledStack) / maxCapacity : 1.0;
+			return rate > floor ? rate : floor;
+		}
+
+		double hitRatio(const Stack& s, size_t capacity) const
+		{
+			uint64_t hits = 0;
+			size_t buckets = std::min(capacity / bucketWidth_, s.histogram.size() - 1);
+			for (size_t i = 0; i < buckets; ++i) hits += s.histogram[i];
+			return static_cast<double>(hits) / sampledGets_;
+		}
+
+		// 锚点从大到小排列：above 为不小于 capacity 的最小锚点，below 为其后一个；超出两端时只用端点的栈
+		double estimate(size_t capacity) const
+		{
+			if (sampledGets_ == 0) return 0.0;
+			size_t above = 0;
+			while (above + 1 < stacks_.size() && stacks_[above + 1].anchor >= capacity) ++above;
+			const Stack& a = stacks_[above];
+			if (a.anchor <= capacity || above + 1 == stacks_.size()) return hitRatio(a, capacity);
+			const Stack& b = stacks_[above + 1];
+			double weight = std::log(capacity / b.anchor) / std::log(a.anchor / b.anchor);
+			return hitRatio(b, capacity) + weight * (hitRatio(a, capacity) - hitRatio(b, capacity));
+		}
+
+		uint32_t allocateSlot()
+		{
+			if (!freeSlots_.empty()) {
+				uint32_t slot = freeSlots_.back();
+				freeSlots_.pop_back();
+				return slot;
+			}
+			for (auto& s : stacks_) s.lastAccess.push_back(0);
+			return static_cast<uint32_t>(stacks_[0].lastAccess.size() - 1);
+		}
+
+		void touch(Stack& s, uint32_t slot, bool isGet, bool tracked)
+		{
+			if (tracked) {
+				uint64_t last = s.lastAccess[slot];
+				// 采样子集上的距离按 1/rate 放大到全量键空间
+				double scaled = (s.marked - prefix(s, last)) / sampler_.rate();
+				if (isGet) {
+					size_t bucket = static_cast<size_t>(scaled / bucketWidth_);
+					if (bucket + 1 < s.histogram.size()) ++s.histogram[bucket];
+					if (scaled >= s.anchor) return; // 该容量下读未命中，键留在原位
+				}
+				unmark(s, last);
+			}
+			if (s.clock + 1 >= s.tree.size()) compact(s);
+			uint64_t now = s.clock++;
+			s.lastAccess[slot] = now;
+			mark(s, now);
+		}
+
+		static void mark(Stack& s, uint64_t t) { for (size_t i = t + 1; i < s.tree.size(); i += i & (~i + 1)) ++s.tree[i]; ++s.marked; }
+		static void unmark(Stack& s, uint64_t t) { for (size_t i = t + 1; i < s.tree.size(); i += i & (~i + 1)) --s.tree[i]; --s.marked; }
+		static uint64_t prefix(const Stack& s, uint64_t t)
+		{
+			uint64_t sum = 0;
+			for (size_t i = t + 1; i > 0; i -= i & (~i + 1)) sum += s.tree[i];
+			return sum;
+		}
+
+		// 时间戳用尽时按原顺序重新编号为 0..n-1，均摊 O(log n)
+		void compact(Stack& s)
+		{
+			std::vector<std::pair<uint64_t, uint32_t>> order; // (时间戳, 槽位)
+			order.reserve(slots_.size());
+			for (auto& kv : slots_) order.emplace_back(s.lastAccess[kv.second], kv.second);
+			std::sort(order.begin(), order.end());
+
+			std::fill(s.tree.begin(), s.tree.end(), 0);
+			s.marked = 0;
+			s.clock = 0;
+			for (auto& p : order) {
+				s.lastAccess[p.second] = s.clock;
+				mark(s, s.clock++);
+			}
+		}
+
+		// 固定样本数：丢弃采样值最大的键并把阈值降到该值
+		void shrinkSample()
+		{
+			auto last = std::prev(bySampleValue_.end());
+			uint64_t value = last->first;
+			sampler_.lowerThreshold(value);
+			while (!bySampleValue_.empty() && std::prev(bySampleValue_.end())->first >= value) {
+				auto victim = std::prev(bySampleValue_.end());
+				auto it = slots_.find(victim->second);
+				if (it != slots_.end()) {
+					for (auto& s : stacks_) unmark(s, s.lastAccess[it->second]);
+					freeSlots_.push_back(it->second);
+					slots_.erase(it);
+				}
+				bySampleValue_.erase(victim);
+			}
+		}
+
+		KeySampler sampler_;
+		size_t maxSamples_;
+		size_t bucketWidth_;
+		uint64_t sampledGets_;
+
+		CacheMutex mutex_;
+		std::vector<Stack> stacks_; // 锚点从大到小
+		std::unordered_map<uint64_t, uint32_t> slots_; // 键哈希 -> 各栈 lastAccess 的下标
+		std::vector<uint32_t> freeSlots_;
+		std::set<std::pair<uint64_t, uint64_t>> bySampleValue_; // (采样值, 键哈希)，即当前跟踪的键
+	};
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace KArcCache {
+
+	// 有损的条带化读缓冲（Caffeine 的 read buffer）：命中时只把节点记入本线程所在条带，不加独占锁，
+	// 攒够一条带后由调用方尝试独占加锁，把缓冲中的访问按记录顺序回放到 LRU 链表 / LFU 频次桶上。
+	// 约定：record 在持有读写锁共享侧时调用，drain 在持有独占侧时调用，两者由这把锁互斥，
+	// 因此槽位本身不需要原子操作，只有条带内的下标是原子的。条带已满又抢不到锁时直接丢弃访问，
+	// 顺序只是近似的，但淘汰总在独占锁下、先排空再进行，单线程下与逐次更新完全一致
+	template<typename T>
+	class ArcReadBuffer {
+	public:
+		ArcReadBuffer() : stripes_(new Stripe[kStripes]), dirty_(0) {}
+
+		ArcReadBuffer(const ArcReadBuffer&) = delete;
+		ArcReadBuffer& operator=(const ArcReadBuffer&) = delete;
+
+		// 返回 true 表示条带已满，调用方应在释放共享锁后尝试排空
+		bool record(T item)
+		{
+			size_t stripe = threadStripe();
+			Stripe& s = stripes_[stripe];
+			uint32_t i = s.count.load(std::memory_order_relaxed);
+			if (i < kSlots) i = s.count.fetch_add(1, std::memory_order_relaxed);
+			if (i >= kSlots) {
+				s.dropped.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+			s.slots[i] = item;
+			if (i == 0) dirty_.fetch_or(1u << stripe, std::memory_order_relaxed);
+			return i + 1 == kSlots;
+		}
+
+		// 按条带依次回放并清空；没有记录时只读一次 dirty_
+		template<typename Apply>
+		void drain(Apply&& apply)
+		{
+			if (dirty_.load(std::memory_order_relaxed) == 0) return;
+			uint32_t mask = dirty_.exchange(0, std::memory_order_relaxed);
+			for (size_t i = 0; i < kStripes; ++i) {
+				if (!(mask & (1u << i))) continue;
+				Stripe& s = stripes_[i];
+				uint32_t n = s.count.load(std::memory_order_relaxed);
+				if (n > kSlots) n = kSlots; // 满后仍有读者递增过下标
+				for (uint32_t j = 0; j < n; ++j) apply(s.slots[j]);
+				s.count.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		// 因条带已满被丢弃的访问次数
+		uint64_t dropped() const
+		{
+			uint64_t n = 0;
+			for (size_t i = 0; i < kStripes; ++i) n += stripes_[i].dropped.load(std::memory_order_relaxed);
+			return n;
+		}
+
+	private:
+		static constexpr size_t kStripes = 16;
+		static constexpr uint32_t kSlots = 32;
+
+		// 末尾补一条缓存行，下一个条带的计数不会和本条带的槽位落在同一行。
+		// 不用 alignas(64)：C++14 的 new 不保证超对齐
+		struct Stripe {
+			std::atomic<uint32_t> count{ 0 };
+			std::atomic<uint64_t> dropped{ 0 };
+			T slots[kSlots];
+			char pad[64];
+		};
+
+		// 每个线程第一次记录时领取一个条带号，线程数不超过条带数时各线程互不共享下标
+		static size_t threadStripe()
+		{
+			static std::atomic<size_t> next{ 0 };
+			thread_local size_t stripe = next.fetch_add(1, std::memory_order_relaxed) & (kStripes - 1);
+			return stripe;
+		}
+
+		std::unique_ptr<Stripe[]> stripes_;
+		std::atomic<uint32_t> dirty_; // 第 i 位表示条带 i 中有待回放的记录
+	};
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace KArcCache {
+
+	// splitmix64 末级混合：std::hash<int> 往往是恒等映射，直接取模采样会和键的分布相关
+	inline uint64_t mixHash(uint64_t h)
+	{
+		h += 0x9e3779b97f4a7c15ull;
+		h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+		h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+		return h ^ (h >> 31);
+	}
+
+	template<typename Key>
+	inline uint64_t sampleHash(const Key& key)
+	{
+		return mixHash(static_cast<uint64_t>(std::hash<Key>{}(key)));
+	}
+
+	// SHARDS 风格的空间采样：按键的哈希决定是否采样，同一个键要么每次都被采样，要么从不被采样，
+	// 因此采样子集上的重用距离按 1/rate 放大即可近似全量
+	class KeySampler {
+	public:
+		static constexpr uint64_t kModulus = 1ull << 24;
+
+		explicit KeySampler(double rate)
+		{
+			if (rate > 1.0) rate = 1.0;
+			uint64_t t = static_cast<uint64_t>(rate * kModulus);
+			threshold_.store(t ? t : 1, std::memory_order_relaxed);
+		}
+
+		uint64_t sampleValue(uint64_t hash) const { return hash & (kModulus - 1); }
+
+		bool sampled(uint64_t hash) const
+		{
+			return sampleValue(hash) < threshold_.load(std::memory_order_relaxed);
+		}
+
+		double rate() const
+		{
+			return static_cast<double>(threshold_.load(std::memory_order_relaxed)) / kModulus;
+		}
+
+		uint64_t threshold() const { return threshold_.load(std::memory_order_relaxed); }
+
+		// 固定样本数模式下降低采样率：之后 sampleValue >= threshold 的键不再被采样
+		void lowerThreshold(uint64_t threshold)
+		{
+			if (threshold && threshold < threshold_.load(std::memory_order_relaxed)) {
+				threshold_.store(threshold, std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		std::atomic<uint64_t> threshold_;
+	};
+}
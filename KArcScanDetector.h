@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include "KInstanceLocal.h"
+
+namespace KArcCache {
+
+	// 检测到扫描后新键的处理方式：插到 LRU 部分的尾部（下一次淘汰最先被逐出），或者干脆不缓存
+	enum class ScanMode : uint8_t { InsertAtTail, Bypass };
+
+	// 扫描检测，两路信号任一成立即判为扫描：
+	//   1. 步长跟踪（仅整数键）：维护 kStreams 条访问流，键恰好接续某条流（步长 +1 或 -1）时该流长度加一，
+	//      长度达到 minRun 即为顺序扫描。流表满时替换最短的流，穿插的随机访问不会挤掉正在进行的长扫描；
+	//   2. 冷未命中连击：连续 minStreak 次访问的键既不在缓存也不在幽灵缓存中（从未被重用），任意一次命中即清零。
+	// 两路都不加锁：流表是每个线程各自一份（分到多个线程交错执行的扫描靠第 2 路识别），连击计数是一个原子计数
+	template<typename Key>
+	class ArcScanDetector {
+	public:
+		ArcScanDetector(size_t minRun, size_t minStreak) :
+			minRun_(minRun ? minRun : 1),
+			minStreak_(minStreak ? minStreak : 1),
+			missStreak_(0) {}
+
+		// 记录一次访问，返回该访问是否属于扫描
+		bool access(const Key& key)
+		{
+			bool sequential = trackStride(key, std::is_integral<Key>());
+			return sequential || missStreak_.load(std::memory_order_relaxed) >= minStreak_;
+		}
+
+		// 访问结果：hit 包括主缓存命中与幽灵命中，二者都说明键被重用了。
+		// 命中时计数多半已是 0，先读一次，避免每次命中都写这条共享的缓存行
+		void recordOutcome(bool hit)
+		{
+			if (!hit) missStreak_.fetch_add(1, std::memory_order_relaxed);
+			else if (missStreak_.load(std::memory_order_relaxed)) missStreak_.store(0, std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr size_t kStreams = 16;
+		static constexpr uint64_t kIdleTicks = 1024; // 这么久没有接续的流视为已结束，可被任意新流替换
+
+		struct Stream {
+			uint64_t last = 0;
+			uint64_t stride = 0; // 1 或 UINT64_MAX（即 -1）；0 表示只见过一个键，方向未定
+			size_t run = 0;     // 0 表示空槽
+			uint64_t lastUse = 0;
+		};
+
+		// 一个线程的流表，tick 按该线程的访问计
+		struct Streams {
+			uint64_t tick = 0;
+			Stream streams[kStreams];
+		};
+
+		static size_t liveRun(const Streams& t, const Stream& s) { return t.tick - s.lastUse > kIdleTicks ? 0 : s.run; }
+
+		bool trackStride(const Key&, std::false_type) { return false; }
+
+		bool trackStride(const Key& key, std::true_type)
+		{
+			// 按 uint64_t 取模相减：有符号键转成 uint64_t 后差值不变，64 位键相减也不会溢出
+			uint64_t k = static_cast<uint64_t>(key);
+			Streams& t = local_.get();
+			++t.tick;
+			size_t victim = 0;
+			for (size_t i = 0; i < kStreams; ++i) {
+				Stream& s = t.streams[i];
+				if (s.run > 0) {
+					uint64_t delta = k - s.last;
+					bool continues = s.stride ? delta == s.stride : (delta == 1 || delta == UINT64_MAX);
+					if (continues) {
+						s.stride = delta;
+						s.last = k;
+						s.run = liveRun(t, s) + 1; // 接续一条早已结束的流时从头计数
+						s.lastUse = t.tick;
+						return s.run >= minRun_;
+					}
+				}
+				const Stream& v = t.streams[victim];
+				if (liveRun(t, s) < liveRun(t, v) || (liveRun(t, s) == liveRun(t, v) && s.lastUse < v.lastUse)) victim = i;
+			}
+			t.streams[victim] = { k, 0, 1, t.tick };
+			return minRun_ <= 1;
+		}
+
+		size_t minRun_;
+		size_t minStreak_;
+		std::atomic<size_t> missStreak_;
+		InstanceLocal<Streams> local_;
+	};
+}
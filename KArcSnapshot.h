@@ -0,0 +1,194 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "KArcCacheNode.h"
+
+namespace KArcCache {
+
+	class SnapshotReader;
+
+	// 快照中键与值的编码。可平凡复制的类型按原样写入字节，std::string 写长度加内容；
+	// 其他类型需要特化 SnapshotCodec，提供 write(std::string&, const T&) 与 read(SnapshotReader&, T&)
+	template<typename T, typename Enable = void>
+	struct SnapshotCodec;
+
+	// 追加写入内存缓冲；计数这类事先不知道的字段先占位，写完后再回填
+	class SnapshotWriter {
+	public:
+		void putU8(uint8_t v) { putRaw(&v, sizeof(v)); }
+		void putU32(uint32_t v) { putRaw(&v, sizeof(v)); }
+		void putU64(uint64_t v) { putRaw(&v, sizeof(v)); }
+		void putRaw(const void* p, size_t n) { buffer_.append(static_cast<const char*>(p), n); }
+
+		template<typename T>
+		void put(const T& v) { SnapshotCodec<T>::write(buffer_, v); }
+
+		// 预留一个 u64，返回其位置
+		size_t reserveU64()
+		{
+			size_t pos = buffer_.size();
+			putU64(0);
+			return pos;
+		}
+
+		void patchU64(size_t pos, uint64_t v) { std::memcpy(&buffer_[pos], &v, sizeof(v)); }
+
+		size_t size() const { return buffer_.size(); }
+
+		void append(const SnapshotWriter& other) { buffer_.append(other.buffer_); }
+
+		// 先写临时文件再改名，写到一半崩溃不会留下残缺的快照
+		bool writeFile(const std::string& path) const
+		{
+			std::string tmp = path + ".tmp";
+			{
+				std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+				if (!out) return false;
+				out.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+				if (!out) return false;
+			}
+			if (std::rename(tmp.c_str(), path.c_str()) == 0) return true;
+			std::remove(path.c_str()); // Windows 上 rename 不覆盖已有文件
+			return std::rename(tmp.c_str(), path.c_str()) == 0;
+		}
+
+	private:
+		std::string buffer_;
+	};
+
+	// 在一段只读内存（通常是映射的快照文件）上顺序解码；越界后 ok() 为 false，之后的读取都失败
+	class SnapshotReader {
+	public:
+		SnapshotReader(const char* data, size_t size) : p_(data), end_(data + size), ok_(true) {}
+
+		bool getRaw(void* dst, size_t n)
+		{
+			if (!ok_ || static_cast<size_t>(end_ - p_) < n) return ok_ = false;
+			std::memcpy(dst, p_, n);
+			p_ += n;
+			return true;
+		}
+
+		bool getU8(uint8_t& v) { return getRaw(&v, sizeof(v)); }
+		bool getU32(uint32_t& v) { return getRaw(&v, sizeof(v)); }
+		bool getU64(uint64_t& v) { return getRaw(&v, sizeof(v)); }
+
+		template<typename T>
+		bool get(T& v) { return ok_ && (ok_ = SnapshotCodec<T>::read(*this, v)); }
+
+		// 直接指向映射内存中的 n 个字节，不复制
+		const char* view(size_t n)
+		{
+			if (!ok_ || static_cast<size_t>(end_ - p_) < n) { ok_ = false; return nullptr; }
+			const char* p = p_;
+			p_ += n;
+			return p;
+		}
+
+		bool ok() const { return ok_; }
+
+	private:
+		const char* p_;
+		const char* end_;
+		bool ok_;
+	};
+
+	template<typename T>
+	struct SnapshotCodec<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type> {
+		static void write(std::string& out, const T& v) { out.append(reinterpret_cast<const char*>(&v), sizeof(T)); }
+		static bool read(SnapshotReader& in, T& v) { return in.getRaw(&v, sizeof(T)); }
+	};
+
+	template<>
+	struct SnapshotCodec<std::string> {
+		static void write(std::string& out, const std::string& v)
+		{
+			uint32_t n = static_cast<uint32_t>(v.size());
+			out.append(reinterpret_cast<const char*>(&n), sizeof(n));
+			out.append(v);
+		}
+
+		static bool read(SnapshotReader& in, std::string& v)
+		{
+			uint32_t n;
+			if (!in.getU32(n)) return false;
+			const char* p = in.view(n);
+			if (!p) return false;
+			v.assign(p, n);
+			return true;
+		}
+	};
+
+	// 文件头：魔数、版本，之后依次是 ArcCache 的全局参数、LFU 部分、LRU 部分（格式见各部分的 snapshot）。
+	// 数值按本机字节序写入，快照只在同一平台的进程之间使用
+	namespace snapshot_format {
+		constexpr char kMagic[8] = { 'K', 'A', 'R', 'C', 'S', 'N', 'A', 'P' };
+		constexpr uint32_t kVersion = 1;
+		constexpr size_t kBatch = 256; // 分批编码时每次持锁编码的节点数
+	}
+
+	// ArcLruPart / ArcLfuPart 共用的条目编码。主缓存条目：键、值、访问次数、标签；
+	// 幽灵条目：键、是否有值、[值]、标签（幽灵节点的访问次数没有意义，不写）
+	template<typename Key, typename Value>
+	struct SnapshotEntry {
+		Key key{};
+		Value value{};
+		uint64_t accessCount = 1;
+		uint64_t tag = 0;
+		bool hasValue = true;
+	};
+
+	template<typename Key, typename Value>
+	void writeSnapshotEntry(SnapshotWriter& out, const ArcNode<Key, Value>& node, bool ghost)
+	{
+		out.put(node.getKey());
+		if (ghost) out.putU8(node.hasValue() ? 1 : 0);
+		if (!ghost || node.hasValue()) out.put(node.getValue());
+		if (!ghost) out.putU64(node.getAccessCount());
+		out.putU64(node.getTag());
+	}
+
+	// 编码一段条目：计数后跟 nodes 中 keep 返回 true 的条目。nodes 是事先持锁按顺序拷出的节点指针，
+	// 编码时每 kBatch 个节点调用一次 lock() 取锁，批与批之间释放，读写可以插进来；
+	// keep 在锁内判断节点是否仍在原来的表里（期间被逐出、删除的跳过）以及标签是否已失效
+	template<typename Key, typename Value, typename LockFn, typename KeepFn>
+	void writeSnapshotSection(SnapshotWriter& out, const std::vector<std::shared_ptr<ArcNode<Key, Value>>>& nodes,
+		bool ghost, const LockFn& lock, const KeepFn& keep)
+	{
+		size_t countPos = out.reserveU64();
+		uint64_t n = 0;
+		for (size_t i = 0; i < nodes.size();) {
+			auto guard = lock();
+			size_t end = nodes.size() - i > snapshot_format::kBatch ? i + snapshot_format::kBatch : nodes.size();
+			for (; i < end; ++i) {
+				if (!keep(nodes[i])) continue;
+				writeSnapshotEntry(out, *nodes[i], ghost);
+				++n;
+			}
+		}
+		out.patchU64(countPos, n);
+	}
+
+	template<typename Key, typename Value>
+	bool readSnapshotEntry(SnapshotReader& in, SnapshotEntry<Key, Value>& e, bool ghost)
+	{
+		e.accessCount = 1;
+		e.hasValue = true;
+		if (!in.get(e.key)) return false;
+		if (ghost) {
+			uint8_t hasValue;
+			if (!in.getU8(hasValue)) return false;
+			e.hasValue = hasValue != 0;
+		}
+		if (e.hasValue && !in.get(e.value)) return false;
+		if (!e.hasValue) e.value = Value();
+		if (!ghost && !in.getU64(e.accessCount)) return false;
+		return in.getU64(e.tag);
+	}
+}
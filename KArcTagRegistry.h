@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "KArcSampler.h"
+
+namespace KArcCache {
+
+	// 标签代际表：每个标签对应一个代际计数，invalidateTag 只把计数加一（O(1)），
+	// 携带旧代际的条目在查找时被惰性判定为过期、在淘汰时直接回收。
+	// 标签按哈希映射到固定数量的槽位，碰撞的标签共享代际，只会多失效一些条目，不会返回过期数据
+	class ArcTagRegistry {
+	public:
+		static constexpr uint64_t kNoTag = 0; // 未打标签的条目永不因标签失效
+
+		explicit ArcTagRegistry(size_t slots = 1024) :
+			mask_(roundUpPow2(slots) - 1),
+			generations_(new std::atomic<uint64_t>[mask_ + 1]) {
+			for (size_t i = 0; i <= mask_; ++i) generations_[i].store(0, std::memory_order_relaxed);
+		}
+
+		uint64_t generation(uint64_t tag) const
+		{
+			if (tag == kNoTag) return 0;
+			return generations_[slot(tag)].load(std::memory_order_acquire);
+		}
+
+		void invalidate(uint64_t tag)
+		{
+			if (tag == kNoTag) return;
+			generations_[slot(tag)].fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		bool isStale(uint64_t tag, uint64_t generation) const
+		{
+			return tag != kNoTag && this->generation(tag) != generation;
+		}
+
+	private:
+		static size_t roundUpPow2(size_t n)
+		{
+			size_t p = 1;
+			while (p < n) p <<= 1;
+			return p;
+		}
+
+		size_t slot(uint64_t tag) const { return static_cast<size_t>(mixHash(tag)) & mask_; }
+
+		size_t mask_;
+		std::unique_ptr<std::atomic<uint64_t>[]> generations_;
+	};
+}
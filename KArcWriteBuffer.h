@@ -0,0 +1,145 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KArcCache.h"
+#include "KArcSampler.h"
+#include "KCacheMutex.h"
+#include "KHashedKey.h"
+
+namespace KArcCache {
+
+	// 写缓冲：put 只把 (键, 值) 记入按哈希分出的条带，同一个键的多次写入在条带里合并为最后一次；
+	// 条带攒满 batchSize 个不同的键后整批交给 ArcCache::putBatch，两部分各只加一次锁。
+	// 读自己的写：get 先查键所在条带，命中就返回缓冲中的值；排空在条带锁内完成，
+	// 读者不会在“已移出条带、尚未写入共享缓存”的间隙读到旧值。
+	// 缓冲中的键还不参与 ARC 的淘汰与自适应，flush() 或析构时全部写入共享缓存
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class ArcWriteBuffer : public KICachePolicy<Key, Value> {
+	public:
+		using Shared = ArcCache<Key, Value, Hash, KeyEqual>;
+
+		explicit ArcWriteBuffer(Shared& shared, size_t batchSize = 32) :
+			shared_(shared),
+			batchSize_(batchSize ? batchSize : 1),
+			stripes_(new Stripe[kStripes]) {}
+
+		~ArcWriteBuffer() override { flush(); }
+
+		void put(Key key, Value value) override {
+			auto hk = shared_.hashKey(std::move(key));
+			Stripe& s = stripeOf(hk);
+			std::lock_guard<CacheMutex> lock(s.mutex);
+			s.pending[hk] = std::move(value);
+			if (s.pending.size() >= batchSize_) drain(s);
+		}
+
+		bool get(Key key, Value& value) override {
+			auto hk = shared_.hashKey(std::move(key));
+			Stripe& s = stripeOf(hk);
+			{
+				std::lock_guard<CacheMutex> lock(s.mutex);
+				auto it = s.pending.find(hk);
+				if (it != s.pending.end()) {
+					value = it->second;
+					return true;
+				}
+			}
+			return shared_.get(hk, value);
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		// 缓冲中的写入一并丢弃
+		bool erase(Key key) {
+			auto hk = shared_.hashKey(std::move(key));
+			Stripe& s = stripeOf(hk);
+			std::lock_guard<CacheMutex> lock(s.mutex);
+			bool buffered = s.pending.erase(hk) > 0;
+			return shared_.erase(hk) || buffered;
+		}
+
+		// 把所有条带中的写入交给共享缓存
+		void flush() {
+			for (size_t i = 0; i < kStripes; ++i) {
+				std::lock_guard<CacheMutex> lock(stripes_[i].mutex);
+				drain(stripes_[i]);
+			}
+		}
+
+		// 尚未写入共享缓存的不同键个数
+		size_t pending() {
+			size_t n = 0;
+			for (size_t i = 0; i < kStripes; ++i) {
+				std::lock_guard<CacheMutex> lock(stripes_[i].mutex);
+				n += stripes_[i].pending.size();
+			}
+			return n;
+		}
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats = shared_.lockStats();
+			for (size_t i = 0; i < kStripes; ++i) {
+				appendLockStats(stats, "wbuf." + std::to_string(i), stripes_[i].mutex);
+			}
+			return stats;
+		}
+
+		// 共享缓存加上缓冲中的条目；缓冲的哈希表计入 index
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			namespace est = memory_estimate;
+			MemoryUsage usage = shared_.memoryUsage(valueSize);
+			for (size_t i = 0; i < kStripes; ++i) {
+				std::lock_guard<CacheMutex> lock(stripes_[i].mutex);
+				const auto& pending = stripes_[i].pending;
+				usage.index += est::hashTable(pending) - pending.size() * sizeof(Value);
+				usage.values += pending.size() * sizeof(Value);
+				if (valueSize) {
+					for (auto& kv : pending) usage.values += valueSize(kv.second);
+				}
+			}
+			return usage;
+		}
+
+	private:
+		static constexpr size_t kStripes = 16;
+
+		// 末尾补一条缓存行，下一个条带的锁不会和本条带的字段落在同一行。
+		// 不用 alignas(64)：C++14 的 new 不保证超对齐
+		struct Stripe {
+			CacheMutex mutex;
+			HashedMap<Key, Value, KeyEqual> pending;
+			std::vector<std::pair<HashedKey<Key>, Value>> batch; // 排空时复用，避免每批重新分配
+			char pad[64];
+		};
+
+		// 条带取混合后哈希的高位，与 ArcFrontCache 的条带划分方式一致
+		Stripe& stripeOf(const HashedKey<Key>& hk)
+		{
+			return stripes_[static_cast<size_t>(mixHash(hk.hash) >> 56) & (kStripes - 1)];
+		}
+
+		// 调用方持有 s.mutex
+		void drain(Stripe& s)
+		{
+			if (s.pending.empty()) return;
+			s.batch.clear();
+			for (auto& kv : s.pending) s.batch.emplace_back(kv.first, std::move(kv.second));
+			s.pending.clear();
+			shared_.putBatch(s.batch);
+		}
+
+		Shared& shared_;
+		size_t batchSize_;
+		std::unique_ptr<Stripe[]> stripes_;
+	};
+}
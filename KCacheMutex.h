@@ -0,0 +1,215 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef KARC_LOCK_STATS
+#include <chrono>
+#endif
+
+namespace KArcCache {
+
+	// 锁统计：等待/持有时间按 ns 的 log2 分桶，第 i 桶覆盖 [2^i, 2^(i+1)) ns
+	struct LockStats {
+		static constexpr size_t kBuckets = 40;
+		uint64_t acquisitions = 0;
+		uint64_t contended = 0; // try_lock 失败、需要等待的次数
+		uint64_t sharedAcquisitions = 0; // 读写锁的共享加锁次数，不计入上面的统计
+		uint64_t waitNs = 0;
+		uint64_t holdNs = 0;
+		std::array<uint64_t, kBuckets> waitHistogram{};
+		std::array<uint64_t, kBuckets> holdHistogram{};
+	};
+
+	struct NamedLockStats {
+		std::string name;
+		LockStats stats;
+	};
+
+	// 轻量读写锁：一个 32 位状态字，无竞争时加锁、解锁各一次原子操作（std::shared_timed_mutex 的独占加锁
+	// 约为 std::mutex 的 4 倍开销，放在每次写入都要走的路径上不划算）。写者优先：有写者等待时新读者让路，
+	// 读多的负载下写者不会饿死。拿不到锁时先自旋几次再 yield，适合临界区很短的缓存操作，不适合长时间持锁。
+	// 只有定义 KARC_SPIN_SHARED_MUTEX 时才用作 CacheSharedMutex
+	class SharedSpinMutex {
+	public:
+		void lock()
+		{
+			for (unsigned spins = 0;; ++spins) {
+				uint32_t s = state_.load(std::memory_order_relaxed);
+				if ((s & (kWriter | kReaders)) == 0) {
+					if (state_.compare_exchange_weak(s, kWriter, std::memory_order_acquire, std::memory_order_relaxed)) return;
+					continue;
+				}
+				if (!(s & kWaiting)) state_.fetch_or(kWaiting, std::memory_order_relaxed);
+				backoff(spins);
+			}
+		}
+
+		bool try_lock()
+		{
+			uint32_t s = state_.load(std::memory_order_relaxed);
+			return (s & (kWriter | kReaders)) == 0
+				&& state_.compare_exchange_strong(s, kWriter, std::memory_order_acquire, std::memory_order_relaxed);
+		}
+
+		// 同时清掉等待位：其他仍在等待的写者会在下一轮重新置位
+		void unlock() { state_.store(0, std::memory_order_release); }
+
+		void lock_shared()
+		{
+			for (unsigned spins = 0; !try_lock_shared(); ++spins) backoff(spins);
+		}
+
+		bool try_lock_shared()
+		{
+			uint32_t s = state_.load(std::memory_order_relaxed);
+			return (s & (kWriter | kWaiting)) == 0
+				&& state_.compare_exchange_strong(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed);
+		}
+
+		void unlock_shared() { state_.fetch_sub(1, std::memory_order_release); }
+
+	private:
+		static constexpr uint32_t kWriter = 1u << 31;
+		static constexpr uint32_t kWaiting = 1u << 30;
+		static constexpr uint32_t kReaders = kWaiting - 1;
+		static constexpr unsigned kSpins = 64;
+
+		static void backoff(unsigned spins)
+		{
+			if (spins >= kSpins) std::this_thread::yield();
+		}
+
+		std::atomic<uint32_t> state_{ 0 };
+	};
+
+	// CacheSharedMutex 的底层锁：默认是阻塞的 std::shared_timed_mutex，restore、clear、按值大小统计内存等
+	// 长时间持锁的操作期间等待方会睡下，不占 CPU；定义 KARC_SPIN_SHARED_MUTEX 时换成 SharedSpinMutex，
+	// 只适合临界区都很短、线程数不超过核数的部署
+#ifdef KARC_SPIN_SHARED_MUTEX
+	using SharedMutexBase = SharedSpinMutex;
+#else
+	using SharedMutexBase = std::shared_timed_mutex;
+#endif
+
+#ifdef KARC_LOCK_STATS
+	constexpr bool kLockStatsEnabled = true;
+
+	// 带统计的互斥量：接口与 Mutex 相同，可直接配合 std::lock_guard / std::unique_lock 使用。
+	// 统计都在持锁期间写入，计数器用 relaxed 原子量只是为了让 stats() 可以不加锁读取。
+	// Mutex 为读写锁时共享加锁只计入 sharedAcquisitions，不计时：读路径本来就是为了不互相等待
+	template<typename Mutex>
+	class BasicInstrumentedMutex {
+	public:
+		void lock()
+		{
+			if (!mutex_.try_lock()) {
+				auto start = Clock::now();
+				mutex_.lock();
+				uint64_t wait = elapsedNs(start);
+				contended_.fetch_add(1, std::memory_order_relaxed);
+				waitNs_.fetch_add(wait, std::memory_order_relaxed);
+				waitHistogram_[bucket(wait)].fetch_add(1, std::memory_order_relaxed);
+			}
+			acquisitions_.fetch_add(1, std::memory_order_relaxed);
+			holdStart_ = Clock::now();
+		}
+
+		bool try_lock()
+		{
+			if (!mutex_.try_lock()) return false;
+			acquisitions_.fetch_add(1, std::memory_order_relaxed);
+			holdStart_ = Clock::now();
+			return true;
+		}
+
+		void unlock()
+		{
+			uint64_t hold = elapsedNs(holdStart_);
+			holdNs_.fetch_add(hold, std::memory_order_relaxed);
+			holdHistogram_[bucket(hold)].fetch_add(1, std::memory_order_relaxed);
+			mutex_.unlock();
+		}
+
+		void lock_shared()
+		{
+			mutex_.lock_shared();
+			sharedAcquisitions_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		bool try_lock_shared()
+		{
+			if (!mutex_.try_lock_shared()) return false;
+			sharedAcquisitions_.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		void unlock_shared() { mutex_.unlock_shared(); }
+
+		LockStats stats() const
+		{
+			LockStats s;
+			s.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+			s.sharedAcquisitions = sharedAcquisitions_.load(std::memory_order_relaxed);
+			s.contended = contended_.load(std::memory_order_relaxed);
+			s.waitNs = waitNs_.load(std::memory_order_relaxed);
+			s.holdNs = holdNs_.load(std::memory_order_relaxed);
+			for (size_t i = 0; i < LockStats::kBuckets; ++i) {
+				s.waitHistogram[i] = waitHistogram_[i].load(std::memory_order_relaxed);
+				s.holdHistogram[i] = holdHistogram_[i].load(std::memory_order_relaxed);
+			}
+			return s;
+		}
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		static uint64_t elapsedNs(Clock::time_point start)
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+		}
+
+		static size_t bucket(uint64_t ns)
+		{
+			size_t b = 0;
+			while (ns > 1 && b + 1 < LockStats::kBuckets) { ns >>= 1; ++b; }
+			return b;
+		}
+
+		Mutex mutex_;
+		Clock::time_point holdStart_;
+		std::atomic<uint64_t> acquisitions_{ 0 };
+		std::atomic<uint64_t> sharedAcquisitions_{ 0 };
+		std::atomic<uint64_t> contended_{ 0 };
+		std::atomic<uint64_t> waitNs_{ 0 };
+		std::atomic<uint64_t> holdNs_{ 0 };
+		std::array<std::atomic<uint64_t>, LockStats::kBuckets> waitHistogram_{};
+		std::array<std::atomic<uint64_t>, LockStats::kBuckets> holdHistogram_{};
+	};
+
+	using InstrumentedMutex = BasicInstrumentedMutex<std::mutex>;
+	using CacheMutex = InstrumentedMutex;
+	using CacheSharedMutex = BasicInstrumentedMutex<SharedMutexBase>;
+
+	template<typename Mutex>
+	void appendLockStats(std::vector<NamedLockStats>& out, const std::string& name, const BasicInstrumentedMutex<Mutex>& mutex)
+	{
+		out.push_back({ name, mutex.stats() });
+	}
+#else
+	constexpr bool kLockStatsEnabled = false;
+
+	// 未定义 KARC_LOCK_STATS 时就是 std::mutex，统计接口全部是空操作
+	using CacheMutex = std::mutex;
+	// 读写锁：读路径用 std::shared_lock，写路径用 std::lock_guard / std::unique_lock
+	using CacheSharedMutex = SharedMutexBase;
+
+	inline void appendLockStats(std::vector<NamedLockStats>&, const std::string&, const std::mutex&) {}
+	inline void appendLockStats(std::vector<NamedLockStats>&, const std::string&, const std::shared_timed_mutex&) {}
+	inline void appendLockStats(std::vector<NamedLockStats>&, const std::string&, const SharedSpinMutex&) {}
+#endif
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KCacheMutex.h"
+#include "KArcCache.h"
+#include "KArcIndexCore.h"
+#include "KArcSampler.h"
+
+namespace KArcCache {
+
+	// CompactArcCache 的数组元素与两部分状态，供 ArcIndexCore 使用
+	template<typename K, typename V>
+	struct CompactArcLayout : ArcIndex {
+		using Key = K;
+		using Value = V;
+		using HashValue = uint32_t;
+
+		struct List {
+			uint32_t head = kNil;
+			uint32_t tail = kNil;
+			uint32_t size = 0;
+		};
+
+		// int -> int 时 32 字节，正好两个节点一条缓存行
+		struct Node {
+			Key key{};
+			Value value{};
+			uint32_t hash = 0;
+			uint32_t accessCount = 1; // LRU 部分判断晋升，LFU 部分即频次
+			uint32_t prev = kNil;     // 所在链表：LRU 主链表、幽灵链表或频次桶内的链表
+			uint32_t next = kNil;
+			uint32_t bucket = kNil;   // LFU 主缓存节点所在的频次桶
+			uint8_t where = kFree;
+			bool hasValue = true;     // 幽灵节点的值被作废后只保留键
+		};
+
+		// LFU 部分的频次桶按频次升序串成链表，头部即最小频次，增加频次和逐出都是 O(1)
+		struct FreqBucket {
+			uint32_t freq = 0;
+			List items;    // 头部最早进入该频次
+			uint32_t prev = kNil;
+			uint32_t next = kNil; // 空闲桶借用 next 串联
+		};
+
+		struct Part {
+			size_t capacity = 0;
+			size_t ghostCapacity = 0;
+			List main;      // LRU 部分：头部为最近访问；LFU 部分只用 size，节点挂在频次桶上
+			List ghost;     // 头部为最近逐出
+			uint32_t freqHead = kNil;
+			uint32_t freqTail = kNil;
+			std::vector<uint64_t> table; // 高 32 位为哈希，低 32 位为节点下标
+			uint32_t mask = 0;
+		};
+	};
+
+	// 紧凑版 ArcCache：键和值可平凡复制且各不超过 16 字节时，不再为每个条目分配 shared_ptr 节点和 unordered_map 节点。
+	// 替换算法在 ArcIndexCore 中与 ShmArcCache 共用，与 ArcCache 同一算法（细节差异使命中率相差 1 个百分点以内）。全部节点（主缓存与两部分幽灵缓存，共 2 倍容量）在构造时
+	// 一次分配在连续数组里，链表与频次桶用 32 位下标内嵌在节点中；两部分各有一张线性探测的开放寻址表，
+	// 槽位是“32 位哈希 | 节点下标”，探测时先比哈希，不命中就不必访问节点。删除用向后移位，不留墓碑。
+	// 整个缓存一把锁。只提供 KICachePolicy 与 erase / size，不支持标签、扫描检测、MRC、自动调参、读写缓冲与快照
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class CompactArcCache : public KICachePolicy<Key, Value>,
+		private ArcIndexCore<CompactArcCache<Key, Value, Hash, KeyEqual>, CompactArcLayout<Key, Value>> {
+		static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+			"CompactArcCache stores keys and values inline in arrays");
+
+		using Core = ArcIndexCore<CompactArcCache, CompactArcLayout<Key, Value>>;
+		friend Core;
+
+	public:
+		explicit CompactArcCache(size_t capacity = 20, size_t transformThreshold = 2) :
+			capacity_(capacity < kMaxCapacity ? capacity : kMaxCapacity),
+			transformThreshold_(transformThreshold),
+			nodes_(capacity_ * 2),
+			buckets_(capacity_ + 1)
+		{
+			this->resetParts(capacity_);
+			// 每部分最多容纳全部主缓存加上本部分的幽灵缓存，表的装载率不超过 3/4
+			initTable(lru_, capacity_ + lru_.ghostCapacity);
+			initTable(lfu_, capacity_ + lfu_.ghostCapacity);
+			this->resetFreeLists(static_cast<uint32_t>(nodes_.size()), static_cast<uint32_t>(buckets_.size()));
+		}
+
+		~CompactArcCache() override = default;
+
+		void put(Key key, Value value) override {
+			uint32_t h = hashOf(key);
+			std::lock_guard<CacheMutex> lk(mutex_);
+			this->putEntry(key, h, value);
+		}
+
+		bool get(Key key, Value& value) override {
+			uint32_t h = hashOf(key);
+			std::lock_guard<CacheMutex> lk(mutex_);
+			return this->getEntry(key, h, value);
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		// 删除单个键（包括两部分幽灵缓存中的记录），返回是否删除了常驻条目
+		bool erase(Key key) {
+			uint32_t h = hashOf(key);
+			std::lock_guard<CacheMutex> lk(mutex_);
+			return this->eraseEntry(key, h);
+		}
+
+		size_t getCapacity() const { return capacity_; }
+
+		size_t size() {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			return this->entryCount();
+		}
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			appendLockStats(stats, "compact-arc", mutex_);
+			return stats;
+		}
+
+		// 数组按容量一次分配：节点数组中主缓存的槽位计入 nodes / values，幽灵槽位计入 ghost
+		MemoryUsage memoryUsage(const ValueSizer<Value>& = nullptr) override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			MemoryUsage usage;
+			usage.entries = this->entryCount();
+			usage.index = (lru_.table.capacity() + lfu_.table.capacity()) * sizeof(uint64_t);
+			usage.nodes = sizeof(*this) + capacity_ * (sizeof(Node) - sizeof(Value));
+			usage.ghost = (nodes_.capacity() - capacity_) * sizeof(Node);
+			usage.freqBuckets = buckets_.capacity() * sizeof(FreqBucket);
+			usage.values = capacity_ * sizeof(Value);
+			return usage;
+		}
+
+	private:
+		using Node = typename Core::Node;
+		using FreqBucket = typename Core::FreqBucket;
+		using Part = typename Core::Part;
+
+		static constexpr uint32_t kNil = ArcIndex::kNil;
+		static constexpr uint64_t kEmptySlot = UINT64_MAX;
+		static constexpr size_t kMaxCapacity = (UINT32_MAX - 1) / 2;
+
+		static void initTable(Part& p, size_t maxNodes)
+		{
+			size_t slots = 16;
+			while (slots * 3 < maxNodes * 4) slots <<= 1;
+			uint64_t empty = kEmptySlot;
+			p.table.assign(slots, empty);
+			p.mask = static_cast<uint32_t>(slots - 1);
+		}
+
+		// std::hash<int> 往往是恒等映射，线性探测下连续的键会连成一片，先做一次混合
+		uint32_t hashOf(const Key& key) const
+		{
+			return static_cast<uint32_t>(mixHash(static_cast<uint64_t>(hash_(key))));
+		}
+
+		// ---- ArcIndexCore 的存储 ----
+
+		Node* nodes() { return nodes_.data(); }
+		FreqBucket* buckets() { return buckets_.data(); }
+		Part& lruPart() { return lru_; }
+		Part& lfuPart() { return lfu_; }
+		uint32_t& freeNodeHead() { return freeNode_; }
+		uint32_t& freeBucketHead() { return freeBucket_; }
+		size_t transformThreshold() const { return transformThreshold_; }
+
+		// ---- 每部分的开放寻址表 ----
+
+		static uint64_t makeSlot(uint32_t h, uint32_t i) { return (static_cast<uint64_t>(h) << 32) | i; }
+		static uint32_t slotHash(uint64_t s) { return static_cast<uint32_t>(s >> 32); }
+		static uint32_t slotIndex(uint64_t s) { return static_cast<uint32_t>(s); }
+
+		uint32_t find(const Part& p, const Key& key, uint32_t h) const
+		{
+			for (uint32_t s = h & p.mask;; s = (s + 1) & p.mask) {
+				uint64_t slot = p.table[s];
+				if (slot == kEmptySlot) return kNil;
+				if (slotHash(slot) == h && equal_(nodes_[slotIndex(slot)].key, key)) return slotIndex(slot);
+			}
+		}
+
+		void linkIndex(Part& p, uint32_t i)
+		{
+			uint32_t h = nodes_[i].hash;
+			uint32_t s = h & p.mask;
+			while (p.table[s] != kEmptySlot) s = (s + 1) & p.mask;
+			p.table[s] = makeSlot(h, i);
+		}
+
+		// 向后移位删除：空出的槽位之后、探测链仍经过它的条目依次前移，查找遇到空槽即可停止
+		void unlinkIndex(Part& p, uint32_t i)
+		{
+			uint32_t hole = nodes_[i].hash & p.mask;
+			while (slotIndex(p.table[hole]) != i) hole = (hole + 1) & p.mask;
+			for (uint32_t s = (hole + 1) & p.mask; p.table[s] != kEmptySlot; s = (s + 1) & p.mask) {
+				uint32_t home = slotHash(p.table[s]) & p.mask;
+				// home 不在 (hole, s] 之间时，该条目可以前移到 hole
+				if (((s - home) & p.mask) >= ((s - hole) & p.mask)) {
+					p.table[hole] = p.table[s];
+					hole = s;
+				}
+			}
+			p.table[hole] = kEmptySlot;
+		}
+
+		size_t capacity_;
+		size_t transformThreshold_;
+		Hash hash_;
+		KeyEqual equal_;
+		CacheMutex mutex_;
+		std::vector<Node> nodes_;
+		std::vector<FreqBucket> buckets_;
+		uint32_t freeNode_ = kNil;
+		uint32_t freeBucket_ = kNil;
+		Part lru_;
+		Part lfu_;
+	};
+
+	// 键和值可平凡复制且各不超过 16 字节时可用 CompactArcCache
+	template<typename Key, typename Value>
+	struct IsCompactArcEligible : std::integral_constant<bool,
+		std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value &&
+		sizeof(Key) <= 16 && sizeof(Value) <= 16> {};
+
+	// 编译期选择实现（std::conditional，C++14 可用）：符合条件的键值类型用 CompactArcCache，其余用 ArcCache。
+	// 因此对符合条件的类型，ArcCacheFor 只有 KICachePolicy、erase、size 与 getCapacity；
+	// 同一段代码换成别的键值类型可能就换了实现，需要标签、快照等 ArcCache 功能时直接写 ArcCache
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	using ArcCacheFor = typename std::conditional<IsCompactArcEligible<Key, Value>::value,
+		CompactArcCache<Key, Value, Hash, KeyEqual>, ArcCache<Key, Value, Hash, KeyEqual>>::type;
+}
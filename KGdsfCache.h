@@ -0,0 +1,210 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KCacheMutex.h"
+
+namespace KArcCache {
+
+	// GreedyDual-Size-Frequency：优先级 H = L + freq * cost / size，逐出 H 最小的条目，并把膨胀值 L 抬到它的 H。
+	// 新写入与刚命中的条目都以当前 L 为基准，长期未访问的条目随 L 上升而相对老化，无需周期性衰减。
+	// 容量按字节计，优化的是单位字节节省的未命中代价，而不是命中次数
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class KGdsfCache : public KICachePolicy<Key, Value> {
+	public:
+		// capacityBytes 为所有条目 size 之和的上限；sizer 为空时，不带 size 的 put 按 1 字节计（退化为按条目数计容量）
+		explicit KGdsfCache(size_t capacityBytes, ValueSizer<Value> sizer = nullptr, double defaultCost = 1.0) :
+			capacity_(capacityBytes),
+			used_(0),
+			inflation_(0.0),
+			defaultCost_(defaultCost),
+			sizer_(std::move(sizer)) {}
+
+		~KGdsfCache() override = default;
+
+		void put(Key key, Value value) override {
+			size_t size = sizer_ ? sizer_(value) : 1;
+			put(std::move(key), std::move(value), defaultCost_, size);
+		}
+
+		// cost：未命中时重新获取的代价（任意单位，例如毫秒）；size：占用的字节数，0 按 1 计。
+		// 与 LFU 一致，put 不增加频次；size 超过总容量的条目不缓存（已有的旧值一并删除）
+		void put(Key key, Value value, double cost, size_t size) {
+			size = std::max<size_t>(size, 1);
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = entries_.find(key);
+			if (size > capacity_) {
+				if (it != entries_.end()) removeEntry(&*it);
+				return;
+			}
+			if (it != entries_.end()) {
+				Entry& e = it->second;
+				used_ = used_ - e.size + size;
+				e.value = std::move(value);
+				e.cost = cost;
+				e.size = size;
+				e.priority = priorityOf(e);
+				fixHeap(e.heapIndex);
+				while (used_ > capacity_ && !heap_.empty()) evictOne();
+				return;
+			}
+
+			while (used_ + size > capacity_ && !heap_.empty()) evictOne();
+			auto res = entries_.emplace(std::move(key), Entry{ std::move(value), cost, size, 1, 0.0, heap_.size() });
+			Slot* slot = &*res.first;
+			slot->second.priority = priorityOf(slot->second);
+			heap_.push_back(slot);
+			siftUp(heap_.size() - 1);
+			used_ += size;
+		}
+
+		bool get(Key key, Value& value) override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = entries_.find(key);
+			if (it == entries_.end()) return false;
+			Entry& e = it->second;
+			value = e.value;
+			++e.frequency;
+			e.priority = priorityOf(e); // L 只增不减，优先级只会变大
+			siftDown(e.heapIndex);
+			return true;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		bool erase(Key key) {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = entries_.find(key);
+			if (it == entries_.end()) return false;
+			removeEntry(&*it);
+			return true;
+		}
+
+		size_t getCapacity() const { return capacity_; }
+
+		size_t usedBytes() {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			return used_;
+		}
+
+		// 当前膨胀值 L，即最近一次逐出条目的优先级
+		double inflation() {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			return inflation_;
+		}
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			appendLockStats(stats, "gdsf", mutex_);
+			return stats;
+		}
+
+		// 条目元数据与值同在哈希节点里；优先队列计入 freqBuckets
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			namespace est = memory_estimate;
+			std::lock_guard<CacheMutex> lk(mutex_);
+			MemoryUsage usage;
+			usage.entries = entries_.size();
+			usage.index = est::hashTable(entries_) - entries_.size() * sizeof(Value);
+			usage.freqBuckets = heap_.capacity() * sizeof(Slot*);
+			usage.values = entries_.size() * sizeof(Value);
+			usage.exact = static_cast<bool>(valueSize);
+			if (valueSize) {
+				for (auto& kv : entries_) usage.values += valueSize(kv.second.value);
+			}
+			return usage;
+		}
+
+	private:
+		struct Entry {
+			Value value;
+			double cost;
+			size_t size;
+			size_t frequency;
+			double priority;
+			size_t heapIndex; // 在 heap_ 中的下标，随上浮/下沉同步更新
+		};
+
+		using EntryMap = std::unordered_map<Key, Entry, Hash, KeyEqual>;
+		using Slot = typename EntryMap::value_type;
+
+		double priorityOf(const Entry& e) const
+		{
+			return inflation_ + static_cast<double>(e.frequency) * e.cost / static_cast<double>(e.size);
+		}
+
+		void evictOne()
+		{
+			Slot* victim = heap_.front();
+			inflation_ = victim->second.priority;
+			removeEntry(victim);
+		}
+
+		void removeEntry(Slot* slot)
+		{
+			size_t index = slot->second.heapIndex;
+			used_ -= slot->second.size;
+			swapNodes(index, heap_.size() - 1);
+			heap_.pop_back();
+			if (index < heap_.size()) fixHeap(index);
+			entries_.erase(slot->first);
+		}
+
+		// 最小堆：堆中存的是哈希表节点的地址，unordered_map 的节点在 rehash 时不会移动
+		bool less(size_t a, size_t b) const { return heap_[a]->second.priority < heap_[b]->second.priority; }
+
+		void swapNodes(size_t a, size_t b)
+		{
+			std::swap(heap_[a], heap_[b]);
+			heap_[a]->second.heapIndex = a;
+			heap_[b]->second.heapIndex = b;
+		}
+
+		void siftUp(size_t i)
+		{
+			while (i > 0) {
+				size_t parent = (i - 1) / 2;
+				if (!less(i, parent)) break;
+				swapNodes(i, parent);
+				i = parent;
+			}
+		}
+
+		void siftDown(size_t i)
+		{
+			while (true) {
+				size_t smallest = i;
+				size_t left = 2 * i + 1;
+				size_t right = left + 1;
+				if (left < heap_.size() && less(left, smallest)) smallest = left;
+				if (right < heap_.size() && less(right, smallest)) smallest = right;
+				if (smallest == i) break;
+				swapNodes(i, smallest);
+				i = smallest;
+			}
+		}
+
+		void fixHeap(size_t i)
+		{
+			siftUp(i);
+			siftDown(i);
+		}
+
+		size_t capacity_;
+		size_t used_;
+		double inflation_;
+		double defaultCost_;
+		ValueSizer<Value> sizer_;
+		CacheMutex mutex_;
+		EntryMap entries_;
+		std::vector<Slot*> heap_;
+	};
+}
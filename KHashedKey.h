@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+namespace KArcCache {
+
+	// 携带预先算好哈希值的键。ArcCache 每次操作只调用一次 Hash，
+	// 之后两部分的主表、幽灵表以及采样器都直接复用这个值，std::string 之类的长键不再被反复哈希
+	template<typename Key>
+	struct HashedKey {
+		Key key;
+		size_t hash;
+	};
+
+	template<typename Key>
+	struct HashedKeyHash {
+		size_t operator()(const HashedKey<Key>& k) const noexcept { return k.hash; }
+	};
+
+	// 先比哈希值再比键：不同键几乎总在第一步就被排除
+	template<typename Key, typename KeyEqual>
+	struct HashedKeyEqual {
+		bool operator()(const HashedKey<Key>& a, const HashedKey<Key>& b) const
+		{
+			return a.hash == b.hash && KeyEqual()(a.key, b.key);
+		}
+	};
+
+	template<typename Key, typename Mapped, typename KeyEqual = std::equal_to<Key>>
+	using HashedMap = std::unordered_map<HashedKey<Key>, Mapped, HashedKeyHash<Key>, HashedKeyEqual<Key, KeyEqual>>;
+
+	template<typename Hash, typename Key>
+	HashedKey<Key> makeHashedKey(const Hash& hash, Key key)
+	{
+		size_t h = hash(key);
+		return { std::move(key), h };
+	}
+}
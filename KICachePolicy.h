@@ -1,4 +1,6 @@
 #pragma once
+#include "KMemoryUsage.h"
+#include "KCacheMutex.h"
 namespace KArcCache
 {
 
@@ -16,6 +18,12 @@ namespace KArcCache
         // 如果缓存中能找到key，则直接返回value
         virtual Value get(Key key) = 0;
 
+        // 内存占用分解；valueSize 为空时只按 sizeof(Value) 估算值的大小。未实现的策略返回全 0
+        virtual MemoryUsage memoryUsage(const ValueSizer<Value>& = nullptr) { return MemoryUsage(); }
+
+        // 各把锁的获取/竞争次数与等待、持有时间直方图；未定义 KARC_LOCK_STATS 时返回空
+        virtual std::vector<NamedLockStats> lockStats() { return {}; }
+
     };
 
 } // namespace KamaCache
\ No newline at end of file
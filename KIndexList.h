@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace KArcCache {
+
+	constexpr uint32_t kNilIndex = UINT32_MAX;
+
+	// 基于下标的节点池：节点连续存放在 vector 里，用 32 位下标代替 shared_ptr/weak_ptr 互相链接。
+	// 每个节点带 Links 组 prev/next，可以同时挂在 Links 条不同的 IndexList 上（例如 LIRS 的栈 S 与队列 Q）。
+	// 释放的槽位串成空闲链表复用，节点数稳定后不再分配内存
+	template<typename T, size_t Links = 1>
+	class IndexPool {
+	public:
+		struct Node {
+			T value;
+			uint32_t prev[Links];
+			uint32_t next[Links];
+		};
+
+		IndexPool() : free_(kNilIndex), live_(0) {}
+
+		void reserve(size_t n) { nodes_.reserve(n); }
+
+		uint32_t allocate()
+		{
+			uint32_t i;
+			if (free_ != kNilIndex) {
+				i = free_;
+				free_ = nodes_[i].next[0];
+			}
+			else {
+				i = static_cast<uint32_t>(nodes_.size());
+				nodes_.emplace_back();
+			}
+			for (size_t l = 0; l < Links; ++l) nodes_[i].prev[l] = nodes_[i].next[l] = kNilIndex;
+			++live_;
+			return i;
+		}
+
+		// 值重置为默认构造，及时释放其持有的堆内存
+		void release(uint32_t i)
+		{
+			nodes_[i].value = T();
+			nodes_[i].next[0] = free_;
+			free_ = i;
+			--live_;
+		}
+
+		T& operator[](uint32_t i) { return nodes_[i].value; }
+		const T& operator[](uint32_t i) const { return nodes_[i].value; }
+		Node& node(uint32_t i) { return nodes_[i]; }
+
+		size_t live() const { return live_; }
+		size_t slots() const { return nodes_.capacity(); }
+
+	private:
+		std::vector<Node> nodes_;
+		uint32_t free_; // 空闲链表头，借用 next[0] 串联
+		size_t live_;
+	};
+
+	// 挂在 IndexPool 第 Link 组指针上的双向链表。front 为最新端，back 为最旧端。
+	// 链表不记录节点是否在表中，由调用方负责（通常用节点上的状态位）
+	template<size_t Link>
+	class IndexList {
+	public:
+		IndexList() : head_(kNilIndex), tail_(kNilIndex), size_(0) {}
+
+		template<typename Pool>
+		void pushFront(Pool& pool, uint32_t i)
+		{
+			auto& n = pool.node(i);
+			n.prev[Link] = kNilIndex;
+			n.next[Link] = head_;
+			if (head_ != kNilIndex) pool.node(head_).prev[Link] = i;
+			else tail_ = i;
+			head_ = i;
+			++size_;
+		}
+
+		template<typename Pool>
+		void pushBack(Pool& pool, uint32_t i)
+		{
+			auto& n = pool.node(i);
+			n.next[Link] = kNilIndex;
+			n.prev[Link] = tail_;
+			if (tail_ != kNilIndex) pool.node(tail_).next[Link] = i;
+			else head_ = i;
+			tail_ = i;
+			++size_;
+		}
+
+		template<typename Pool>
+		void remove(Pool& pool, uint32_t i)
+		{
+			auto& n = pool.node(i);
+			if (n.prev[Link] != kNilIndex) pool.node(n.prev[Link]).next[Link] = n.next[Link];
+			else head_ = n.next[Link];
+			if (n.next[Link] != kNilIndex) pool.node(n.next[Link]).prev[Link] = n.prev[Link];
+			else tail_ = n.prev[Link];
+			n.prev[Link] = n.next[Link] = kNilIndex;
+			--size_;
+		}
+
+		template<typename Pool>
+		void moveToFront(Pool& pool, uint32_t i)
+		{
+			if (head_ == i) return;
+			remove(pool, i);
+			pushFront(pool, i);
+		}
+
+		uint32_t front() const { return head_; }
+		uint32_t back() const { return tail_; }
+		bool empty() const { return size_ == 0; }
+		size_t size() const { return size_; }
+
+	private:
+		uint32_t head_;
+		uint32_t tail_;
+		size_t size_;
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace KArcCache {
+
+	// 每个对象、每个线程各一份的数据。thread_local 只能是静态的，按对象区分要靠一张线程本地表，表项以对象编号为键。
+	// 编号全局递增、永不复用，对象销毁后新建的对象不会读到旧对象遗留的数据；
+	// 表项同时记下对象的存活令牌（weak_ptr），对象销毁后令牌失效，线程下一次为新对象建表项时顺带清掉失效的表项。
+	// 线程退出时整张表随之析构
+	template<typename T>
+	class InstanceLocal {
+	public:
+		InstanceLocal() : id_(nextId()), alive_(std::make_shared<char>(0)) {}
+
+		InstanceLocal(const InstanceLocal&) = delete;
+		InstanceLocal& operator=(const InstanceLocal&) = delete;
+
+		// 本线程的那一份；第一次访问时默认构造后交给 init 初始化。同一线程连续访问同一对象时只比较一次编号
+		template<typename Init>
+		T& get(Init init)
+		{
+			Table& table = localTable();
+			if (table.lastId == id_) return *table.last;
+			auto it = table.entries.find(id_);
+			if (it == table.entries.end()) {
+				purge(table);
+				it = table.entries.emplace(id_, Entry{ alive_, T() }).first;
+				init(it->second.value);
+			}
+			table.lastId = id_;
+			table.last = &it->second.value;
+			return it->second.value;
+		}
+
+		T& get() { return get([](T&) {}); }
+
+	private:
+		struct Entry {
+			std::weak_ptr<char> alive;
+			T value;
+		};
+
+		struct Table {
+			uint64_t lastId = 0;
+			T* last = nullptr;
+			std::unordered_map<uint64_t, Entry> entries; // 节点式容器，rehash 不移动 value
+		};
+
+		static uint64_t nextId()
+		{
+			static std::atomic<uint64_t> counter{ 0 };
+			return counter.fetch_add(1, std::memory_order_relaxed) + 1; // 0 留给 Table::lastId 表示空
+		}
+
+		static Table& localTable()
+		{
+			thread_local Table table;
+			return table;
+		}
+
+		// 只在新建表项时调用，每个线程对每个对象最多一次
+		static void purge(Table& table)
+		{
+			for (auto it = table.entries.begin(); it != table.entries.end();) {
+				if (it->second.alive.expired()) it = table.entries.erase(it);
+				else ++it;
+			}
+		}
+
+		uint64_t id_;
+		std::shared_ptr<char> alive_;
+	};
+}
@@ -0,0 +1,236 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "KICachePolicy.h"
+#include "KCacheMutex.h"
+#include "KIndexList.h"
+
+namespace KArcCache {
+
+	// LIRS（Jiang & Zhang, SIGMETRICS 2002）：按“两次访问之间隔了多少个不同的键”（IRR）而不是最近一次访问时间区分冷热。
+	// 容量分为 LIR 区（约 99%，IRR 低的键）与常驻 HIR 区（约 1%，队列 Q）。栈 S 按访问时间记录 LIR、常驻 HIR
+	// 以及非常驻 HIR（只有键，没有值），栈底始终是 LIR（剪枝）。HIR 键在栈中被再次访问说明其 IRR 低于栈底的
+	// LIR 键，两者交换身份。循环长度超过容量时，LRU 会把每个键在重用前逐出，LIRS 则固定保留其中一部分。
+	// 非常驻条目另挂在一条 FIFO 上，数量超过 nonResidentLimit 时从最旧的开始丢弃，S 的大小因此有界
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class KLirsCache : public KICachePolicy<Key, Value> {
+	public:
+		// hirPercent：常驻 HIR 区占容量的百分比（论文取 1%，容量大于 1 时至少 1 个）；nonResidentLimit 为 0 时取 2 倍容量
+		explicit KLirsCache(size_t capacity, double hirPercent = 1.0, size_t nonResidentLimit = 0) :
+			capacity_(capacity),
+			lirCapacity_(0),
+			nonResidentLimit_(nonResidentLimit ? nonResidentLimit : 2 * capacity),
+			lirCount_(0)
+		{
+			// 至少留 1 个 LIR 槽位，否则栈底无 LIR 可依、剪枝失去意义；容量为 1 时 Q 为空
+			size_t hir = std::max<size_t>(1, static_cast<size_t>(capacity * hirPercent / 100.0));
+			hir = std::min(hir, capacity ? capacity - 1 : 0);
+			lirCapacity_ = capacity - hir;
+		}
+
+		~KLirsCache() override = default;
+
+		// 写入也算一次访问；写入非常驻 HIR 键等同于一次栈内未命中，直接成为 LIR
+		void put(Key key, Value value) override {
+			if (capacity_ == 0) return;
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = index_.find(key);
+			if (it != index_.end()) {
+				uint32_t i = it->second;
+				Entry& e = pool_[i];
+				e.value = std::move(value);
+				if (e.state != State::HirNonResident) {
+					touch(i);
+					return;
+				}
+				// 先摘出非常驻 FIFO 并标为常驻，腾位置时的裁剪与剪枝就不会删掉它
+				nonResident_.remove(pool_, i);
+				e.state = State::HirResident;
+				makeRoom();
+				promote(i);
+				return;
+			}
+
+			makeRoom();
+			uint32_t i = pool_.allocate();
+			Entry& e = pool_[i];
+			e.key = key;
+			e.value = std::move(value);
+			e.inStack = true;
+			stack_.pushFront(pool_, i);
+			index_.emplace(std::move(key), i);
+			if (lirCount_ < lirCapacity_) {
+				e.state = State::Lir; // 预热阶段：LIR 区未满时新键直接成为 LIR
+				++lirCount_;
+			}
+			else {
+				e.state = State::HirResident;
+				queue_.pushFront(pool_, i);
+			}
+		}
+
+		bool get(Key key, Value& value) override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = index_.find(key);
+			if (it == index_.end()) return false;
+			uint32_t i = it->second;
+			if (pool_[i].state == State::HirNonResident) return false; // 没有值，只能等下一次 put
+			value = pool_[i].value;
+			touch(i);
+			return true;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		size_t getCapacity() const { return capacity_; }
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			appendLockStats(stats, "lirs", mutex_);
+			return stats;
+		}
+
+		// 非常驻 HIR 条目（键 + 节点）计入 ghost；节点池按已分配槽位统计
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			namespace est = memory_estimate;
+			using Node = typename Pool::Node;
+			std::lock_guard<CacheMutex> lk(mutex_);
+			size_t nonResident = nonResidentCount();
+			size_t resident = index_.size() - nonResident;
+			MemoryUsage usage;
+			usage.entries = resident;
+			usage.index = est::hashTable(index_) - nonResident * est::hashNode<Key, uint32_t>();
+			usage.nodes = pool_.slots() * sizeof(Node) - resident * sizeof(Value) - nonResident * sizeof(Node);
+			usage.ghost = nonResident * (sizeof(Node) + est::hashNode<Key, uint32_t>());
+			usage.values = resident * sizeof(Value);
+			usage.exact = static_cast<bool>(valueSize);
+			if (valueSize) {
+				for (auto& kv : index_) {
+					if (pool_[kv.second].state != State::HirNonResident) usage.values += valueSize(pool_[kv.second].value);
+				}
+			}
+			return usage;
+		}
+
+	private:
+		enum class State : uint8_t { Lir, HirResident, HirNonResident };
+
+		struct Entry {
+			Key key{};
+			Value value{};
+			State state = State::Lir;
+			bool inStack = false;
+		};
+
+		// 第 0 组指针挂栈 S；第 1 组挂常驻 HIR 队列 Q 或非常驻 FIFO（二者互斥）
+		using Pool = IndexPool<Entry, 2>;
+
+		size_t residentCount() const { return lirCount_ + queue_.size(); }
+		size_t nonResidentCount() const { return nonResident_.size(); }
+
+		// 命中常驻条目
+		void touch(uint32_t i)
+		{
+			Entry& e = pool_[i];
+			if (e.state == State::Lir) {
+				bool wasBottom = stack_.back() == i;
+				stack_.moveToFront(pool_, i);
+				if (wasBottom) prune();
+				return;
+			}
+			if (e.inStack) { // 栈内的常驻 HIR：IRR 低于栈底 LIR，升为 LIR
+				queue_.remove(pool_, i);
+				promote(i);
+				return;
+			}
+			// 已被剪出栈的常驻 HIR：重新入栈，仍是 HIR，移到 Q 的最新端
+			e.inStack = true;
+			stack_.pushFront(pool_, i);
+			queue_.moveToFront(pool_, i);
+		}
+
+		// i 已不在 Q / 非常驻 FIFO 中；置为 LIR 放到栈顶，LIR 区超额时把栈底 LIR 降为 HIR
+		void promote(uint32_t i)
+		{
+			Entry& e = pool_[i];
+			e.state = State::Lir;
+			++lirCount_;
+			if (e.inStack) stack_.moveToFront(pool_, i);
+			else { e.inStack = true; stack_.pushFront(pool_, i); }
+			while (lirCount_ > lirCapacity_) demoteBottom();
+			prune();
+		}
+
+		void demoteBottom()
+		{
+			uint32_t b = stack_.back();
+			Entry& e = pool_[b];
+			stack_.remove(pool_, b);
+			e.inStack = false;
+			e.state = State::HirResident;
+			--lirCount_;
+			queue_.pushFront(pool_, b);
+			prune();
+		}
+
+		// 栈剪枝：弹出栈底所有 HIR 条目，保证栈底是 LIR。每个条目入栈一次至多被弹一次，均摊 O(1)
+		void prune()
+		{
+			while (!stack_.empty() && pool_[stack_.back()].state != State::Lir) {
+				uint32_t b = stack_.back();
+				stack_.remove(pool_, b);
+				pool_[b].inStack = false;
+				if (pool_[b].state == State::HirNonResident) {
+					nonResident_.remove(pool_, b);
+					drop(b);
+				}
+			}
+		}
+
+		// 常驻条目已满时逐出 Q 中最旧的 HIR；仍在栈中的变为非常驻，否则彻底删除
+		void makeRoom()
+		{
+			if (residentCount() < capacity_) return;
+			if (queue_.empty()) demoteBottom();
+			uint32_t victim = queue_.back();
+			queue_.remove(pool_, victim);
+			Entry& e = pool_[victim];
+			if (!e.inStack) {
+				drop(victim);
+				return;
+			}
+			e.state = State::HirNonResident;
+			e.value = Value();
+			nonResident_.pushFront(pool_, victim);
+			while (nonResident_.size() > nonResidentLimit_) {
+				uint32_t oldest = nonResident_.back();
+				nonResident_.remove(pool_, oldest);
+				stack_.remove(pool_, oldest); // 非常驻条目不会在栈底，删除后无需剪枝
+				drop(oldest);
+			}
+		}
+
+		void drop(uint32_t i)
+		{
+			index_.erase(pool_[i].key);
+			pool_.release(i);
+		}
+
+		size_t capacity_;
+		size_t lirCapacity_;
+		size_t nonResidentLimit_;
+		size_t lirCount_;
+		CacheMutex mutex_;
+		std::unordered_map<Key, uint32_t, Hash, KeyEqual> index_;
+		Pool pool_;
+		IndexList<0> stack_;        // 栈 S，front 为栈顶
+		IndexList<1> queue_;        // 常驻 HIR 队列 Q，back 最旧
+		IndexList<1> nonResident_;  // 非常驻 HIR 的 FIFO，back 最旧
+	};
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace KArcCache {
+
+	// 只读内存映射整个文件，析构时解除映射。打开失败或文件为空时 valid() 为 false
+	class MappedFile {
+	public:
+		explicit MappedFile(const std::string& path) { open(path); }
+		~MappedFile() { close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool valid() const { return data_ != nullptr; }
+		const char* data() const { return data_; }
+		size_t size() const { return size_; }
+
+	private:
+#ifdef _WIN32
+		void open(const std::string& path)
+		{
+			file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file_ == INVALID_HANDLE_VALUE) return;
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) return;
+			mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping_) return;
+			data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+			if (data_) size_ = static_cast<size_t>(size.QuadPart);
+		}
+
+		void close()
+		{
+			if (data_) UnmapViewOfFile(data_);
+			if (mapping_) CloseHandle(mapping_);
+			if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+		}
+
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#else
+		void open(const std::string& path)
+		{
+			fd_ = ::open(path.c_str(), O_RDONLY);
+			if (fd_ < 0) return;
+			struct stat st;
+			if (fstat(fd_, &st) != 0 || st.st_size == 0) return;
+			void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+			if (p == MAP_FAILED) return;
+			madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL); // 顺序读一遍，提示内核预读
+			data_ = static_cast<const char*>(p);
+			size_ = static_cast<size_t>(st.st_size);
+		}
+
+		void close()
+		{
+			if (data_) munmap(const_cast<char*>(data_), size_);
+			if (fd_ >= 0) ::close(fd_);
+		}
+
+		int fd_ = -1;
+#endif
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+	};
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <utility>
+
+namespace KArcCache {
+
+	// 值的额外堆内存（例如 std::string 超出 SSO 的缓冲区）；为空时只统计 sizeof(Value)
+	template<typename Value>
+	using ValueSizer = std::function<size_t(const Value&)>;
+
+	// 各策略的内存占用分解（字节）。values 是有效载荷，其余都是缓存自身的元数据开销
+	struct MemoryUsage {
+		size_t entries = 0;     // 常驻条目数
+		size_t index = 0;       // 主哈希表：桶数组 + 哈希节点
+		size_t nodes = 0;       // 缓存节点（含 make_shared 控制块、哨兵节点），不含内嵌的 Value
+		size_t ghost = 0;       // 幽灵缓存 / 访问历史：哈希表、节点以及其中保存的值
+		size_t freqBuckets = 0; // 频次桶：桶表与桶内链表节点
+		size_t values = 0;      // 常驻值：sizeof(Value) + ValueSizer 报告的堆内存
+		bool exact = false;     // 是否用 ValueSizer 逐个统计了值的堆内存
+
+		size_t metadata() const { return index + nodes + ghost + freqBuckets; }
+		size_t total() const { return metadata() + values; }
+
+		MemoryUsage& operator+=(const MemoryUsage& other)
+		{
+			entries += other.entries;
+			index += other.index;
+			nodes += other.nodes;
+			ghost += other.ghost;
+			freqBuckets += other.freqBuckets;
+			values += other.values;
+			exact = exact && other.exact;
+			return *this;
+		}
+	};
+
+	// 按主流标准库（libstdc++ / MSVC STL）的节点布局估算容器开销，不含分配器自身的对齐与头部
+	namespace memory_estimate {
+
+		// 单向链式节点：next 指针 + 键值对 + 缓存的哈希值
+		template<typename Key, typename Mapped>
+		constexpr size_t hashNode() { return sizeof(void*) + sizeof(std::pair<const Key, Mapped>) + sizeof(size_t); }
+
+		template<typename Map>
+		size_t hashTable(const Map& map)
+		{
+			using Key = typename Map::key_type;
+			using Mapped = typename Map::mapped_type;
+			return map.bucket_count() * sizeof(void*) + map.size() * hashNode<Key, Mapped>();
+		}
+
+		// make_shared 把对象与控制块（虚表指针 + 强/弱引用计数）放在同一次分配里
+		template<typename T>
+		constexpr size_t sharedNode() { return sizeof(T) + sizeof(void*) + 2 * sizeof(int); }
+
+		template<typename T>
+		constexpr size_t listNode() { return sizeof(T) + 2 * sizeof(void*); }
+	}
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KCacheMutex.h"
+#include "KArcSampler.h"
+#include "KArcCache.h"
+#include "LRU_K.h"
+#include "LFU.h"
+
+namespace KArcCache {
+
+	// 元策略：真实数据只放在一个“当前策略”实例里，另外在哈希采样出的键子集上为每个候选策略各跑一个
+	// 缩小版影子实例（值用 Value() 占位）。影子命中数按窗口统计，每个窗口结束时减半，
+	// 某个候选连续 kConfirmEpochs 个窗口领先当前策略超过 margin 才切换（滞回，避免来回抖动）。
+	// 切换时新建一个空的目标策略，旧实例保留 handoff 期：新实例未命中时回查旧实例，命中的条目顺带搬过去，
+	// 期满后丢弃旧实例。KICachePolicy 不支持遍历，搬迁只能这样按需进行
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class KMetaCache : public KICachePolicy<Key, Value> {
+	public:
+		using Policy = KICachePolicy<Key, Value>;
+		using Factory = std::function<std::unique_ptr<Policy>(size_t capacity)>;
+
+		struct Candidate {
+			std::string name;
+			Factory make;
+		};
+
+		// LRU / LFU / ARC 三个候选，参数与各测试场景中单独使用时一致
+		static std::vector<Candidate> defaultCandidates(int lfuMaxAverage = 10, size_t arcThreshold = 2)
+		{
+			std::vector<Candidate> candidates;
+			candidates.push_back({ "LRU", [](size_t cap) {
+				return std::unique_ptr<Policy>(new KLruCache<Key, Value, Hash, KeyEqual>(static_cast<int>(cap))); } });
+			candidates.push_back({ "LFU", [lfuMaxAverage](size_t cap) {
+				return std::unique_ptr<Policy>(new KLfuCache<Key, Value, Hash, KeyEqual>(static_cast<int>(cap), lfuMaxAverage)); } });
+			candidates.push_back({ "ARC", [arcThreshold](size_t cap) {
+				return std::unique_ptr<Policy>(new ArcCache<Key, Value, Hash, KeyEqual>(cap, arcThreshold)); } });
+			return candidates;
+		}
+
+		// 从第一个候选开始；hysteresis 为领先幅度占窗口读次数的比例
+		KMetaCache(size_t capacity, std::vector<Candidate> candidates = defaultCandidates(),
+			double sampleRate = 0.01, size_t epochGets = 1000, double hysteresis = 0.02) :
+			capacity_(capacity),
+			sampler_(effectiveRate(capacity, sampleRate)),
+			epochGets_(std::max<size_t>(epochGets, 1)),
+			margin_(static_cast<uint64_t>(epochGets_ * hysteresis)),
+			epochCount_(0),
+			current_(0),
+			leader_(0),
+			leaderEpochs_(0),
+			handoffLeft_(0),
+			switches_(0)
+		{
+			// 影子容量与真实容量同比缩小；缓存不足 kMinShadowCapacity 时采样率为 1，影子与真实实例同样大
+			size_t shadowCapacity = std::max<size_t>(static_cast<size_t>(capacity * sampler_.rate() + 0.5), 1);
+			for (auto& c : candidates) {
+				Shadow s;
+				s.name = c.name;
+				s.make = std::move(c.make);
+				s.shadow = s.make(shadowCapacity);
+				s.hits = 0;
+				shadows_.push_back(std::move(s));
+			}
+			active_ = shadows_[current_].make(capacity_);
+		}
+
+		~KMetaCache() override = default;
+
+		// handoff 期间旧实例里可能还留着这个键，一并更新，避免新实例逐出它之后回查到旧值
+		void put(Key key, Value value) override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			if (sampler_.sampled(mixHash(hash_(key)))) {
+				for (auto& s : shadows_) s.shadow->put(key, Value());
+			}
+			if (previous_) previous_->put(key, value);
+			active_->put(std::move(key), std::move(value));
+		}
+
+		bool get(Key key, Value& value) override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			if (sampler_.sampled(mixHash(hash_(key)))) recordShadows(key);
+			bool hit = active_->get(key, value);
+			if (previous_) {
+				if (!hit && previous_->get(key, value)) {
+					active_->put(key, value);
+					hit = true;
+				}
+				if (--handoffLeft_ == 0) previous_.reset();
+			}
+			return hit;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		size_t getCapacity() const { return capacity_; }
+
+		// 当前承载真实数据的策略名
+		std::string activePolicy() {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			return shadows_[current_].name;
+		}
+
+		size_t switches() {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			return switches_;
+		}
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			std::vector<NamedLockStats> stats;
+			appendLockStats(stats, "meta", mutex_);
+			for (auto& s : active_->lockStats()) stats.push_back({ "meta." + s.name, s.stats });
+			return stats;
+		}
+
+		// 当前实例与 handoff 中的旧实例照常统计；影子实例只是访问历史，整体计入 ghost
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			MemoryUsage usage = active_->memoryUsage(valueSize);
+			if (previous_) usage += previous_->memoryUsage(valueSize);
+			for (auto& s : shadows_) usage.ghost += s.shadow->memoryUsage().total();
+			return usage;
+		}
+
+	private:
+		struct Shadow {
+			std::string name;
+			Factory make;
+			std::unique_ptr<Policy> shadow;
+			uint64_t hits;
+		};
+
+		static constexpr size_t kMinShadowCapacity = 256;
+		static constexpr size_t kConfirmEpochs = 2;
+
+		static double effectiveRate(size_t capacity, double sampleRate)
+		{
+			if (capacity == 0) return 1.0;
+			double minRate = static_cast<double>(kMinShadowCapacity) / capacity;
+			return std::min(1.0, std::max(sampleRate, minRate));
+		}
+
+		void recordShadows(const Key& key)
+		{
+			Value unused;
+			for (auto& s : shadows_) {
+				if (s.shadow->get(key, unused)) ++s.hits;
+			}
+			if (++epochCount_ < epochGets_) return;
+			endEpoch();
+		}
+
+		void endEpoch()
+		{
+			size_t best = current_;
+			for (size_t i = 0; i < shadows_.size(); ++i) {
+				if (shadows_[i].hits > shadows_[best].hits) best = i;
+			}
+			bool leads = best != current_ && shadows_[best].hits > shadows_[current_].hits + margin_;
+			if (!leads) leaderEpochs_ = 0;
+			else if (best == leader_) ++leaderEpochs_;
+			else { leader_ = best; leaderEpochs_ = 1; }
+
+			if (leaderEpochs_ >= kConfirmEpochs) switchTo(best);
+			for (auto& s : shadows_) s.hits /= 2;
+			epochCount_ = 0;
+		}
+
+		// 上一次 handoff 还没结束就再次切换时，更早的实例直接丢弃
+		void switchTo(size_t next)
+		{
+			previous_ = std::move(active_);
+			active_ = shadows_[next].make(capacity_);
+			handoffLeft_ = std::max<size_t>(capacity_, epochGets_);
+			current_ = next;
+			leaderEpochs_ = 0;
+			++switches_;
+		}
+
+		size_t capacity_;
+		Hash hash_;
+		KeySampler sampler_;
+		size_t epochGets_;
+		uint64_t margin_;
+		size_t epochCount_;
+		size_t current_;
+		size_t leader_;
+		size_t leaderEpochs_;
+		size_t handoffLeft_; // 旧实例还能再被回查的 get 次数
+		size_t switches_;
+		CacheMutex mutex_;
+		std::vector<Shadow> shadows_;
+		std::unique_ptr<Policy> active_;
+		std::unique_ptr<Policy> previous_;
+	};
+}
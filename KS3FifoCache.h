@@ -0,0 +1,214 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KCacheMutex.h"
+
+namespace KArcCache {
+
+	// S3-FIFO（Yang et al., SOSP 2023）：小 FIFO S（约 10% 容量）、主 FIFO M 和只存键哈希的幽灵 FIFO G。
+	// 新键进 S；S 尾部的条目若在 S 中被访问过就移入 M，否则逐出并记入 G。G 中出现过的键再次写入时直接进 M。
+	// M 尾部的条目频次大于 0 时减一后重新插回头部（CLOCK 式二次机会），否则逐出。
+	// 命中只把 2 位频次（上限 3）原子地加一，不移动任何节点：读路径只持共享锁，多个读者互不阻塞。
+	// 只访问一次的扫描键在 S 中就被逐出，碰不到 M 里的热点
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class KS3FifoCache : public KICachePolicy<Key, Value> {
+	public:
+		// smallPercent：S 占容量的百分比，论文取 10%；G 的长度与 M 相同
+		explicit KS3FifoCache(size_t capacity, double smallPercent = 10.0) :
+			capacity_(capacity),
+			smallTarget_(std::max<size_t>(1, static_cast<size_t>(capacity * smallPercent / 100.0))),
+			slots_(new Entry[capacity]),
+			small_(capacity),
+			main_(capacity),
+			ghost_(capacity > smallTarget_ ? capacity - smallTarget_ : 1)
+		{
+			freeSlots_.reserve(capacity);
+			for (size_t i = capacity; i > 0; --i) freeSlots_.push_back(static_cast<uint32_t>(i - 1));
+			index_.reserve(capacity);
+		}
+
+		~KS3FifoCache() override = default;
+
+		// 已有键只更新值，不算一次访问
+		void put(Key key, Value value) override {
+			if (capacity_ == 0) return;
+			std::lock_guard<CacheSharedMutex> lk(mutex_);
+			auto it = index_.find(key);
+			if (it != index_.end()) {
+				slots_[it->second].value = std::move(value);
+				return;
+			}
+
+			if (freeSlots_.empty()) evict();
+			size_t h = hash_(key);
+			uint32_t i = freeSlots_.back();
+			freeSlots_.pop_back();
+			Entry& e = slots_[i];
+			e.key = key;
+			e.value = std::move(value);
+			e.freq.store(0, std::memory_order_relaxed);
+			if (ghostCount_.count(h)) main_.push(i);
+			else small_.push(i);
+			index_.emplace(std::move(key), i);
+		}
+
+		bool get(Key key, Value& value) override {
+			std::shared_lock<CacheSharedMutex> lk(mutex_);
+			auto it = index_.find(key);
+			if (it == index_.end()) return false;
+			Entry& e = slots_[it->second];
+			value = e.value;
+			// 并发读者之间只竞争这一个字节；已到上限就不再写，热点键的缓存行不会被反复弄脏
+			uint8_t f = e.freq.load(std::memory_order_relaxed);
+			while (f < kMaxFreq && !e.freq.compare_exchange_weak(f, static_cast<uint8_t>(f + 1), std::memory_order_relaxed)) {}
+			return true;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		size_t getCapacity() const { return capacity_; }
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			appendLockStats(stats, "s3fifo", mutex_);
+			return stats;
+		}
+
+		// 槽位数组按容量一次分配；两个环形队列计入 nodes，G 的环与计数表计入 ghost
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			namespace est = memory_estimate;
+			std::lock_guard<CacheSharedMutex> lk(mutex_);
+			size_t resident = index_.size();
+			MemoryUsage usage;
+			usage.entries = resident;
+			usage.index = est::hashTable(index_);
+			usage.nodes = capacity_ * sizeof(Entry) - resident * sizeof(Value)
+				+ small_.bytes() + main_.bytes() + freeSlots_.capacity() * sizeof(uint32_t);
+			usage.ghost = ghost_.bytes() + est::hashTable(ghostCount_);
+			usage.values = resident * sizeof(Value);
+			usage.exact = static_cast<bool>(valueSize);
+			if (valueSize) {
+				for (auto& kv : index_) usage.values += valueSize(slots_[kv.second].value);
+			}
+			return usage;
+		}
+
+	private:
+		static constexpr uint8_t kMaxFreq = 3;
+
+		struct Entry {
+			Key key{};
+			Value value{};
+			std::atomic<uint8_t> freq{ 0 };
+		};
+
+		// 定长环形队列：push 在头、pop 在尾，插入和逐出都只移动下标，不分配内存也不重链节点
+		template<typename T>
+		class Ring {
+		public:
+			explicit Ring(size_t capacity) : items_(std::max<size_t>(capacity, 1)), head_(0), size_(0) {}
+
+			void push(T item)
+			{
+				items_[(head_ + size_) % items_.size()] = item;
+				++size_;
+			}
+
+			T pop()
+			{
+				T item = items_[head_];
+				head_ = (head_ + 1) % items_.size();
+				--size_;
+				return item;
+			}
+
+			bool empty() const { return size_ == 0; }
+			bool full() const { return size_ == items_.size(); }
+			size_t size() const { return size_; }
+			size_t bytes() const { return items_.capacity() * sizeof(T); }
+
+		private:
+			std::vector<T> items_;
+			size_t head_;
+			size_t size_;
+		};
+
+		// 腾出一个槽位。S 达到目标大小（或 M 为空）时从 S 逐出，否则从 M 逐出；
+		// 每轮要么释放一个槽位，要么把某个条目的频次减一 / 从 S 移到 M，因此循环必然结束
+		void evict()
+		{
+			while (freeSlots_.empty()) {
+				if (small_.size() >= smallTarget_ || main_.empty()) evictSmall();
+				else evictMain();
+			}
+		}
+
+		void evictSmall()
+		{
+			uint32_t i = small_.pop();
+			Entry& e = slots_[i];
+			if (e.freq.load(std::memory_order_relaxed) > 0) {
+				e.freq.store(0, std::memory_order_relaxed);
+				main_.push(i);
+				return;
+			}
+			rememberGhost(hash_(e.key));
+			drop(i);
+		}
+
+		void evictMain()
+		{
+			uint32_t i = main_.pop();
+			Entry& e = slots_[i];
+			uint8_t f = e.freq.load(std::memory_order_relaxed);
+			if (f > 0) {
+				e.freq.store(static_cast<uint8_t>(f - 1), std::memory_order_relaxed);
+				main_.push(i);
+				return;
+			}
+			drop(i);
+		}
+
+		// G 满时先淘汰最旧的哈希；同一哈希可能在环里出现多次，用计数表判断是否仍在 G 中
+		void rememberGhost(size_t h)
+		{
+			if (ghost_.full()) {
+				auto it = ghostCount_.find(ghost_.pop());
+				if (--it->second == 0) ghostCount_.erase(it);
+			}
+			ghost_.push(h);
+			++ghostCount_[h];
+		}
+
+		void drop(uint32_t i)
+		{
+			index_.erase(slots_[i].key);
+			slots_[i].value = Value();
+			freeSlots_.push_back(i);
+		}
+
+		size_t capacity_;
+		size_t smallTarget_;
+		Hash hash_;
+		CacheSharedMutex mutex_;
+		std::unique_ptr<Entry[]> slots_;    // 条目的值与频次，下标即槽位号
+		std::vector<uint32_t> freeSlots_;
+		std::unordered_map<Key, uint32_t, Hash, KeyEqual> index_;
+		Ring<uint32_t> small_;
+		Ring<uint32_t> main_;
+		Ring<size_t> ghost_;
+		std::unordered_map<size_t, uint32_t> ghostCount_;
+	};
+}
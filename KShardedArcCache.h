@@ -0,0 +1,285 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KArcCache.h"
+#include "KArcSampler.h"
+#include "KInstanceLocal.h"
+#include "KSpaceSaving.h"
+
+namespace KArcCache {
+
+	// 按键哈希分片的 ArcCache，每个分片各自加锁。哈希分片挡不住单个爆款键：它的所有请求都落在同一个分片的锁上。
+	// enableHotKeys 之后，随机抽样的读请求进入 Space-Saving 概要，持续占比超过阈值的键被发布到一张不可变的热键表，
+	// 各线程持有该表的本地副本和热键值的本地拷贝，命中时不加任何锁，热点读请求随线程分散到各个核。
+	// 一致性与 ArcFrontCache 相同：put/erase 先写分片再递增键所在条带的版本，本地拷贝记录填充时的版本，不一致即回源；
+	// 本地拷贝被读取 refreshEvery 次后也回源一次，顺带刷新分片中该键的访问顺序，避免热键因长期不访问分片而被逐出
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class ShardedArcCache : public KICachePolicy<Key, Value> {
+	public:
+		using Shard = ArcCache<Key, Value, Hash, KeyEqual>;
+		using KeyType = HashedKey<Key>;
+
+		// 总容量平均分给各分片
+		explicit ShardedArcCache(size_t capacity, size_t shards = 16, size_t transformThreshold = 2) :
+			hotEnabled_(false),
+			hotGeneration_(0),
+			stripes_(new Stripe[kStripes]) {
+			shards = std::max<size_t>(1, shards);
+			size_t perShard = std::max<size_t>(1, capacity / shards);
+			for (size_t i = 0; i < shards; ++i) shards_.push_back(std::make_unique<Slot>(perShard, transformThreshold));
+		}
+
+		~ShardedArcCache() override = default;
+
+		// 开启热键检测与复制：平均每 sampleEvery 次读抽样一次，保证占比不低于 threshold 的键（最多 maxHotKeys 个）进入热键表。
+		// 需在并发访问开始前调用
+		void enableHotKeys(size_t maxHotKeys = 16, double threshold = 0.01, size_t sampleEvery = 16, size_t refreshEvery = 1024) {
+			maxHotKeys_ = std::max<size_t>(1, maxHotKeys);
+			threshold_ = threshold;
+			sampleEvery_ = std::max<size_t>(1, sampleEvery);
+			refreshEvery_ = std::max<size_t>(1, refreshEvery);
+			// 计数器数为 k 时，占比超过 1/k 的键一定被跟踪；取阈值所需的两倍留出余量
+			size_t counters = std::max(maxHotKeys_ * 4, static_cast<size_t>(2.0 / std::max(threshold, 1e-6)));
+			sketch_ = std::make_unique<SpaceSaving<Key, KeyEqual>>(counters);
+			hotEnabled_ = true;
+		}
+
+		void put(Key key, Value value) override {
+			KeyType hk = shards_[0]->cache.hashKey(std::move(key));
+			uint64_t h = mixHash(hk.hash);
+			shardOf(h).put(hk, value);
+			// 先写分片再递增版本：读线程若在递增前拿到旧值，它记下的版本必然已过期
+			if (hotEnabled_) bumpStripe(h);
+		}
+
+		bool get(Key key, Value& value) override {
+			KeyType hk = shards_[0]->cache.hashKey(std::move(key));
+			uint64_t h = mixHash(hk.hash);
+			if (!hotEnabled_) return shardOf(h).get(hk, value);
+
+			LocalState& local = local_.get();
+			refreshTable(local);
+			sample(local, hk);
+			int index = local.table ? local.table->find(hk, h) : -1;
+			if (index < 0) return shardOf(h).get(hk, value);
+
+			Replica& replica = local.replicas[index];
+			uint64_t version = stripeVersion(h);
+			if (replica.valid && replica.version == version && ++replica.served < refreshEvery_) {
+				value = replica.value;
+				return true;
+			}
+			replica.valid = shardOf(h).get(hk, value);
+			if (replica.valid) replica.value = value;
+			replica.version = version;
+			replica.served = 0;
+			return replica.valid;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		bool erase(Key key) {
+			KeyType hk = shards_[0]->cache.hashKey(std::move(key));
+			uint64_t h = mixHash(hk.hash);
+			bool erased = shardOf(h).erase(hk);
+			if (hotEnabled_) bumpStripe(h);
+			return erased;
+		}
+
+		// 当前热键表中的键，按检测时的计数从大到小
+		std::vector<Key> hotKeys() {
+			std::lock_guard<std::mutex> lock(hotMutex_);
+			std::vector<Key> keys;
+			if (hotTable_) {
+				for (const auto& k : hotTable_->keys) keys.push_back(k.key);
+			}
+			return keys;
+		}
+
+		// 各分片实际收到的请求数（热键表命中不计入），用来观察负载是否倾斜
+		std::vector<uint64_t> shardLoads() const {
+			std::vector<uint64_t> loads;
+			for (const auto& s : shards_) loads.push_back(s->requests.load(std::memory_order_relaxed));
+			return loads;
+		}
+
+		size_t shardCount() const { return shards_.size(); }
+
+		// 热键值的线程本地拷贝最多 maxHotKeys 个，不计入
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			MemoryUsage usage;
+			for (auto& s : shards_) usage += s->cache.memoryUsage(valueSize);
+			return usage;
+		}
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			for (size_t i = 0; i < shards_.size(); ++i) {
+				for (auto& s : shards_[i]->cache.lockStats()) {
+					s.name = "shard" + std::to_string(i) + "." + s.name;
+					stats.push_back(std::move(s));
+				}
+			}
+			return stats;
+		}
+
+	private:
+		static constexpr size_t kStripes = 256;
+		// 每积累这么多个样本重建一次热键表，随后概要计数减半
+		static constexpr uint64_t kRebuildSamples = 4096;
+
+		// 请求计数之后补齐一条缓存行，紧随其后分配的下一个分片不会和它伪共享。
+		// 这里和 Stripe 都不用 alignas(64)：C++14 的 new / make_unique 不保证超对齐，g++ 报 -Waligned-new、MSVC 报 C4316
+		struct Slot {
+			Slot(size_t capacity, size_t transformThreshold) : cache(capacity, transformThreshold), requests(0) {}
+			Shard cache;
+			std::atomic<uint64_t> requests;
+			char pad[64 - sizeof(std::atomic<uint64_t>)];
+		};
+
+		// 补齐到 64 字节，相邻版本号相距一整条缓存行
+		struct Stripe {
+			std::atomic<uint64_t> version{ 0 };
+			char pad[64 - sizeof(std::atomic<uint64_t>)];
+		};
+
+		// 发布后只读：键数组加一张开放寻址的下标表
+		struct HotTable {
+			std::vector<KeyType> keys;
+			std::vector<int> slots;
+			size_t mask = 0;
+			uint64_t generation = 0;
+
+			int find(const KeyType& key, uint64_t h) const {
+				for (size_t i = h & mask;; i = (i + 1) & mask) {
+					int s = slots[i];
+					if (s < 0 || HashedKeyEqual<Key, KeyEqual>()(keys[s], key)) return s;
+				}
+			}
+		};
+
+		struct Replica {
+			Value value{};
+			uint64_t version = 0;
+			size_t served = 0;
+			bool valid = false;
+		};
+
+		struct LocalState {
+			std::shared_ptr<const HotTable> table;
+			uint64_t generation = 0;
+			std::vector<Replica> replicas;
+			uint64_t rng = 0;
+		};
+
+		Shard& shardOf(uint64_t h)
+		{
+			Slot& slot = *shards_[h % shards_.size()];
+			slot.requests.fetch_add(1, std::memory_order_relaxed);
+			return slot.cache;
+		}
+
+		// 热键表换代后才加锁取一次新表；本地拷贝全部作废
+		void refreshTable(LocalState& local)
+		{
+			if (hotGeneration_.load(std::memory_order_acquire) == local.generation) return;
+			std::lock_guard<std::mutex> lock(hotMutex_);
+			local.table = hotTable_;
+			local.generation = hotTable_ ? hotTable_->generation : 0;
+			local.replicas.assign(hotTable_ ? hotTable_->keys.size() : 0, Replica());
+		}
+
+		// 按 1/sampleEvery 的概率随机抽样（固定步长会和周期性的访问模式对齐）。
+		// 抽样有损：概要正被其他线程更新时直接丢弃这个样本，检测本身不成为新的争用点
+		void sample(LocalState& local, const KeyType& key)
+		{
+			if (!local.rng) local.rng = mixHash(reinterpret_cast<uintptr_t>(&local)) | 1;
+			local.rng ^= local.rng << 13;
+			local.rng ^= local.rng >> 7;
+			local.rng ^= local.rng << 17;
+			if (local.rng % sampleEvery_) return;
+			std::unique_lock<std::mutex> lock(sketchMutex_, std::try_to_lock);
+			if (!lock.owns_lock()) return;
+			sketch_->offer(key);
+			if (++samples_ < kRebuildSamples) return;
+			samples_ = 0;
+			publish(sketch_->heavyHitters(threshold_, maxHotKeys_));
+			sketch_->decay();
+		}
+
+		// 调用方持有 sketchMutex_；热键集合没有变化时不换表，各线程的本地拷贝继续有效
+		void publish(const std::vector<typename SpaceSaving<Key, KeyEqual>::Counter>& hitters)
+		{
+			auto table = std::make_shared<HotTable>();
+			for (const auto& c : hitters) table->keys.push_back(c.key);
+			{
+				std::lock_guard<std::mutex> lock(hotMutex_);
+				if (sameKeys(table->keys)) return;
+			}
+			size_t slots = 1;
+			while (slots < table->keys.size() * 2) slots <<= 1;
+			table->mask = slots - 1;
+			table->slots.assign(slots, -1);
+			for (size_t i = 0; i < table->keys.size(); ++i) {
+				size_t s = mixHash(table->keys[i].hash) & table->mask;
+				while (table->slots[s] >= 0) s = (s + 1) & table->mask;
+				table->slots[s] = static_cast<int>(i);
+			}
+			std::lock_guard<std::mutex> lock(hotMutex_);
+			table->generation = hotGeneration_.load(std::memory_order_relaxed) + 1;
+			hotTable_ = std::move(table);
+			hotGeneration_.store(hotTable_->generation, std::memory_order_release);
+		}
+
+		bool sameKeys(const std::vector<KeyType>& keys) const
+		{
+			size_t current = hotTable_ ? hotTable_->keys.size() : 0;
+			if (current != keys.size()) return false;
+			for (const auto& k : keys) {
+				if (hotTable_->find(k, mixHash(k.hash)) < 0) return false;
+			}
+			return true;
+		}
+
+		size_t stripeOf(uint64_t h) const { return static_cast<size_t>(h >> 56) & (kStripes - 1); }
+
+		uint64_t stripeVersion(uint64_t h) const
+		{
+			return stripes_[stripeOf(h)].version.load(std::memory_order_acquire);
+		}
+
+		void bumpStripe(uint64_t h)
+		{
+			stripes_[stripeOf(h)].version.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		std::vector<std::unique_ptr<Slot>> shards_;
+
+		bool hotEnabled_;
+		size_t maxHotKeys_ = 16;
+		double threshold_ = 0.01;
+		size_t sampleEvery_ = 16;
+		size_t refreshEvery_ = 1024;
+
+		std::mutex sketchMutex_;
+		std::unique_ptr<SpaceSaving<Key, KeyEqual>> sketch_;
+		uint64_t samples_ = 0;
+
+		std::mutex hotMutex_;
+		std::shared_ptr<const HotTable> hotTable_;
+		std::atomic<uint64_t> hotGeneration_;
+		std::unique_ptr<Stripe[]> stripes_;
+		InstanceLocal<LocalState> local_; // 各线程的热键表副本与热键值拷贝
+	};
+}
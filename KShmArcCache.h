@@ -0,0 +1,570 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <type_traits>
+#include "KICachePolicy.h"
+#include "KArcIndexCore.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace KArcCache {
+
+	// ShmArcCache 段内的节点、频次桶与两部分状态，供 ArcIndexCore 使用。都放在段内，只含定长字段和下标
+	template<typename K, typename V>
+	struct ShmArcLayout : ArcIndex {
+		using Key = K;
+		using Value = V;
+		using HashValue = uint64_t;
+
+		struct List {
+			uint32_t head;
+			uint32_t tail;
+			uint64_t size;
+		};
+
+		struct Node {
+			Key key;
+			Value value;
+			uint64_t hash;
+			uint64_t accessCount; // LRU 部分判断晋升，LFU 部分即频次
+			uint32_t prev;        // 所在链表：LRU 主链表、幽灵链表或频次桶内的链表
+			uint32_t next;
+			uint32_t hashNext;    // 所属部分哈希表的桶内链
+			uint32_t bucket;      // LFU 主缓存节点所在的频次桶
+			uint8_t where;
+			bool hasValue;        // 幽灵节点的值被作废后只保留键
+		};
+
+		// LFU 部分的频次桶按频次升序串成链表，头部即最小频次，增加频次和逐出都是 O(1)
+		struct FreqBucket {
+			uint64_t freq;
+			List items;    // 头部最早进入该频次
+			uint32_t prev;
+			uint32_t next; // 空闲桶借用 next 串联
+		};
+
+		struct Part {
+			uint64_t capacity;
+			uint64_t ghostCapacity;
+			List main;      // LRU 部分：头部为最近访问；LFU 部分只用 size，节点挂在频次桶上
+			List ghost;     // 头部为最近逐出
+			uint32_t freqHead;
+			uint32_t freqTail;
+			uint64_t tableOffset;
+			uint32_t tableMask;
+		};
+	};
+
+	// 放在共享内存段里、供多个进程共用的 ArcCache。替换算法与 CompactArcCache 共用 ArcIndexCore，与 ArcCache 相同。
+	// 段内不能存指针（各进程映射地址不同），节点、频次桶、两部分的哈希表都是段内的定长数组，彼此用 32 位下标链接，
+	// 容量按创建时的参数一次分配，之后不再分配内存。键和值按字节存放，必须可平凡复制（定长字符数组代替 std::string），
+	// Hash 在所有进程中必须给出相同结果。
+	// 整个段由一把进程间共享的健壮锁保护（POSIX 为 PTHREAD_MUTEX_ROBUST 的 pthread 互斥量，Windows 为命名互斥量）：
+	// 持锁进程崩溃后，下一个加锁者得到通知，此时链表可能只改了一半，于是清空缓存重新开始（recoveries() 计数）。
+	// 不支持标签、读写缓冲、MRC 与自动调参
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class ShmArcCache : public KICachePolicy<Key, Value>,
+		private ArcIndexCore<ShmArcCache<Key, Value, Hash, KeyEqual>, ShmArcLayout<Key, Value>> {
+		static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+			"ShmArcCache stores keys and values as raw bytes in shared memory");
+
+		using Core = ArcIndexCore<ShmArcCache, ShmArcLayout<Key, Value>>;
+		friend Core;
+
+	public:
+		// name 为空时创建匿名共享映射，只能由 fork 出的子进程继承；否则按名字打开已有的段，不存在时创建。
+		// capacity / transformThreshold 只在创建段时使用，打开已有段时沿用段内的参数。失败时 valid() 为 false
+		ShmArcCache(const std::string& name, size_t capacity, size_t transformThreshold = 2)
+		{
+			if (capacity == 0 || capacity > kMaxCapacity) return;
+			Layout layout = computeLayout(capacity);
+			bool creator = false;
+			bool ok = mapSegment(name, layout.total, creator);
+			if (ok && creator) initialize(layout, capacity, transformThreshold);
+			else if (ok) ok = compatible();
+			releaseInitLock();
+			if (!ok) unmapSegment();
+		}
+
+		~ShmArcCache() override { unmapSegment(); }
+
+		ShmArcCache(const ShmArcCache&) = delete;
+		ShmArcCache& operator=(const ShmArcCache&) = delete;
+
+		// 删除命名段；已映射的进程不受影响，最后一个进程解除映射后内存才释放。Windows 上段随最后一个句柄关闭而消失
+		static bool remove(const std::string& name)
+		{
+#ifdef _WIN32
+			(void)name;
+			return true;
+#else
+			return shm_unlink(segmentName(name).c_str()) == 0;
+#endif
+		}
+
+		// 段映射失败，或段锁已不可恢复（ENOTRECOVERABLE）时为 false；后者需 remove 后重新创建段
+		bool valid() const { return header_ != nullptr && !broken_.load(std::memory_order_relaxed); }
+
+		void put(Key key, Value value) override {
+			if (!header_) return;
+			uint64_t h = hash_(key);
+			Guard guard(*this);
+			if (!guard) return;
+			this->putEntry(key, h, value);
+		}
+
+		bool get(Key key, Value& value) override {
+			if (!header_) return false;
+			uint64_t h = hash_(key);
+			Guard guard(*this);
+			if (!guard) return false;
+			if (this->getEntry(key, h, value)) {
+				++header_->hits;
+				return true;
+			}
+			++header_->misses;
+			return false;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		// 删除单个键（包括两部分幽灵缓存中的记录），返回是否删除了常驻条目
+		bool erase(Key key) {
+			if (!header_) return false;
+			uint64_t h = hash_(key);
+			Guard guard(*this);
+			if (!guard) return false;
+			return this->eraseEntry(key, h);
+		}
+
+		size_t getCapacity() const { return header_ ? static_cast<size_t>(header_->capacity) : 0; }
+
+		size_t size() {
+			if (!header_) return 0;
+			Guard guard(*this);
+			if (!guard) return 0;
+			return this->entryCount();
+		}
+
+		// 所有进程累计的读命中 / 未命中次数
+		uint64_t hits() {
+			if (!header_) return 0;
+			Guard guard(*this);
+			if (!guard) return 0;
+			return header_->hits;
+		}
+
+		uint64_t misses() {
+			if (!header_) return 0;
+			Guard guard(*this);
+			if (!guard) return 0;
+			return header_->misses;
+		}
+
+		// 因持锁进程崩溃而清空缓存的次数
+		uint64_t recoveries() {
+			if (!header_) return 0;
+			Guard guard(*this);
+			if (!guard) return 0;
+			return header_->recoveries;
+		}
+
+		// 段按容量一次分配：节点数组中主缓存的槽位计入 nodes / values，幽灵槽位计入 ghost
+		MemoryUsage memoryUsage(const ValueSizer<Value>& = nullptr) override {
+			MemoryUsage usage;
+			if (!header_) return usage;
+			Guard guard(*this);
+			if (!guard) return usage;
+			size_t capacity = static_cast<size_t>(header_->capacity);
+			size_t ghostSlots = static_cast<size_t>(header_->nodeCount) - capacity;
+			usage.entries = this->entryCount();
+			usage.index = (static_cast<size_t>(header_->lru.tableMask) + 1 + header_->lfu.tableMask + 1) * sizeof(uint32_t);
+			usage.nodes = sizeof(Header) + capacity * (sizeof(Node) - sizeof(Value));
+			usage.ghost = ghostSlots * sizeof(Node);
+			usage.freqBuckets = static_cast<size_t>(header_->bucketCount) * sizeof(FreqBucket);
+			usage.values = capacity * sizeof(Value);
+			return usage;
+		}
+
+	private:
+		using Node = typename Core::Node;
+		using FreqBucket = typename Core::FreqBucket;
+		using Part = typename Core::Part;
+
+		static constexpr uint32_t kNil = ArcIndex::kNil;
+		static constexpr uint32_t kVersion = 1;
+		static constexpr size_t kMaxCapacity = (UINT32_MAX - 1) / 2;
+
+		struct Header {
+			char magic[8];
+			uint32_t version;
+			std::atomic<uint32_t> state; // 0 未初始化，1 初始化中，2 就绪
+			uint64_t keySize;
+			uint64_t valueSize;
+			uint64_t nodeSize;
+			uint64_t totalBytes;
+			uint64_t capacity;
+			uint64_t transformThreshold;
+			uint64_t nodeCount;
+			uint64_t bucketCount;
+			uint64_t nodesOffset;
+			uint64_t bucketsOffset;
+#ifndef _WIN32
+			pthread_mutex_t mutex;
+#endif
+			uint32_t freeNode;
+			uint32_t freeBucket;
+			Part lru;
+			Part lfu;
+			uint64_t hits;
+			uint64_t misses;
+			uint64_t recoveries;
+		};
+
+		struct Layout {
+			size_t nodes;
+			size_t lruTable;
+			size_t lfuTable;
+			size_t buckets;
+			size_t total;
+			uint32_t lruMask;
+			uint32_t lfuMask;
+		};
+
+		// 锁已不可恢复时 Guard 为假，调用方按段不可用处理：读未命中，写入丢弃
+		class Guard {
+		public:
+			explicit Guard(ShmArcCache& cache) : cache_(cache), locked_(cache.lockSegment()) {}
+			~Guard() { if (locked_) cache_.unlockSegment(); }
+			explicit operator bool() const { return locked_; }
+		private:
+			ShmArcCache& cache_;
+			bool locked_;
+		};
+
+		static size_t alignUp(size_t n) { return (n + 63) & ~static_cast<size_t>(63); }
+
+		static uint32_t tableMaskFor(size_t entries)
+		{
+			size_t n = 16;
+			while (n < entries) n <<= 1;
+			return static_cast<uint32_t>(n - 1);
+		}
+
+		// 节点数为容量的两倍：主缓存合计 capacity 个，两部分幽灵缓存各 capacity / 2 个（与 ArcCache 的初始划分一致）。
+		// 一个键在每部分最多占一个节点，每部分的哈希表按该部分可能容纳的最多节点数分配
+		static Layout computeLayout(size_t capacity)
+		{
+			Layout l;
+			size_t nodeCount = capacity * 2;
+			l.lruMask = tableMaskFor(capacity + capacity / 2);
+			l.lfuMask = tableMaskFor(capacity + capacity - capacity / 2);
+			l.nodes = alignUp(sizeof(Header));
+			l.lruTable = alignUp(l.nodes + nodeCount * sizeof(Node));
+			l.lfuTable = alignUp(l.lruTable + (static_cast<size_t>(l.lruMask) + 1) * sizeof(uint32_t));
+			l.buckets = alignUp(l.lfuTable + (static_cast<size_t>(l.lfuMask) + 1) * sizeof(uint32_t));
+			l.total = alignUp(l.buckets + (capacity + 1) * sizeof(FreqBucket));
+			return l;
+		}
+
+#ifdef _WIN32
+		static std::string segmentName(const std::string& name) { return "Local\\karc_" + name; }
+
+		bool mapSegment(const std::string& name, size_t bytes, bool& creator)
+		{
+			uint64_t size = bytes;
+			const char* mapName = nullptr;
+			std::string segName, lockName;
+			if (!name.empty()) {
+				segName = segmentName(name);
+				lockName = segName + "_lock";
+				mapName = segName.c_str();
+			}
+			mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+				static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), mapName);
+			if (!mapping_) return false;
+			creator = GetLastError() != ERROR_ALREADY_EXISTS;
+			lock_ = CreateMutexA(nullptr, FALSE, name.empty() ? nullptr : lockName.c_str());
+			if (!lock_) return false;
+			void* p = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+			if (!p) return false;
+			MEMORY_BASIC_INFORMATION info;
+			mappedBytes_ = VirtualQuery(p, &info, sizeof(info)) ? info.RegionSize : bytes;
+			bind(static_cast<char*>(p));
+			// 同 POSIX 版：持命名互斥量检查段是否就绪，没有就绪就由本进程初始化。
+			// 上一个持有者退出时未释放，等待返回 WAIT_ABANDONED：段已就绪说明它死在某次操作中途，按 recover 处理
+			DWORD rc = WaitForSingleObject(lock_, INFINITE);
+			initLocked_ = true;
+			creator = header_->state.load(std::memory_order_acquire) != 2;
+			if (creator) return mappedBytes_ >= bytes; // 卡在初始化中的旧段比本进程需要的小时无法复用
+			if (rc == WAIT_ABANDONED && compatible()) recover();
+			return true;
+		}
+
+		void releaseInitLock()
+		{
+			if (initLocked_) ReleaseMutex(lock_);
+			initLocked_ = false;
+		}
+
+		void unmapSegment()
+		{
+			if (base_) UnmapViewOfFile(base_);
+			if (lock_) CloseHandle(lock_);
+			if (mapping_) CloseHandle(mapping_);
+			base_ = nullptr;
+			header_ = nullptr;
+			lock_ = nullptr;
+			mapping_ = nullptr;
+		}
+
+		void initMutex() {}
+
+		// 持有者退出时未释放的命名互斥量返回 WAIT_ABANDONED，语义与健壮锁的 EOWNERDEAD 相同
+		bool lockSegment()
+		{
+			DWORD rc = WaitForSingleObject(lock_, INFINITE);
+			if (rc == WAIT_ABANDONED) recover();
+			else if (rc != WAIT_OBJECT_0) return lockFailed();
+			return true;
+		}
+
+		void unlockSegment() { ReleaseMutex(lock_); }
+
+		HANDLE mapping_ = nullptr;
+		HANDLE lock_ = nullptr;
+		bool initLocked_ = false;
+#else
+		static std::string segmentName(const std::string& name) { return name[0] == '/' ? name : "/" + name; }
+
+		// 命名段的初始化由段上的 flock 串行化：拿到锁后发现段还没有就绪（刚创建的，或上一个初始化者中途崩溃留下的）
+		// 就由本进程设置长度并初始化，creator 为 true；否则映射已有的段。返回时仍持锁，构造函数处理完后 releaseInitLock。
+		// 持锁进程崩溃时内核自动释放 flock，段不会一直卡在"初始化中"
+		bool mapSegment(const std::string& name, size_t bytes, bool& creator)
+		{
+			creator = true;
+			if (name.empty()) return mapFd(-1, bytes);
+			int fd = shm_open(segmentName(name).c_str(), O_RDWR | O_CREAT, 0600);
+			if (fd < 0) return false;
+			initFd_ = fd;
+			struct stat st;
+			while (flock(fd, LOCK_EX) != 0) {
+				if (errno != EINTR) return false;
+			}
+			if (fstat(fd, &st) != 0) return false;
+			size_t size = static_cast<size_t>(st.st_size);
+			if (size >= sizeof(Header) && mapFd(fd, size)) {
+				if (header_->state.load(std::memory_order_acquire) == 2) {
+					creator = false;
+					return true;
+				}
+				unmapSegment();
+			}
+			return ftruncate(fd, static_cast<off_t>(bytes)) == 0 && mapFd(fd, bytes);
+		}
+
+		bool mapFd(int fd, size_t size)
+		{
+			void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | (fd < 0 ? MAP_ANONYMOUS : 0), fd, 0);
+			if (p == MAP_FAILED) return false;
+			mappedBytes_ = size;
+			bind(static_cast<char*>(p));
+			return true;
+		}
+
+		// 映射仍引用着打开的文件，单靠 close 不会释放 flock，须显式解锁；映射建立后不再需要描述符
+		void releaseInitLock()
+		{
+			if (initFd_ < 0) return;
+			flock(initFd_, LOCK_UN);
+			::close(initFd_);
+			initFd_ = -1;
+		}
+
+		void unmapSegment()
+		{
+			if (base_) munmap(base_, mappedBytes_);
+			base_ = nullptr;
+			header_ = nullptr;
+		}
+
+		void initMutex()
+		{
+			pthread_mutexattr_t attr;
+			pthread_mutexattr_init(&attr);
+			pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#ifdef __linux__
+			pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+#endif
+			pthread_mutex_init(&header_->mutex, &attr);
+			pthread_mutexattr_destroy(&attr);
+		}
+
+		// 上一个持锁者崩溃（EOWNERDEAD）时清空缓存并把锁标记为一致。ENOTRECOVERABLE 表示拿到 EOWNERDEAD 的进程
+		// 没有标记一致就解锁了，这把锁再也拿不到：不能不加锁继续访问，只能报告失败
+		bool lockSegment()
+		{
+			int rc = pthread_mutex_lock(&header_->mutex);
+#ifdef __linux__
+			if (rc == EOWNERDEAD) {
+				recover();
+				pthread_mutex_consistent(&header_->mutex);
+				return true;
+			}
+#endif
+			if (rc != 0) return lockFailed();
+			return true;
+		}
+
+		void unlockSegment() { pthread_mutex_unlock(&header_->mutex); }
+
+		int initFd_ = -1;
+#endif
+
+		void bind(char* base)
+		{
+			base_ = base;
+			header_ = reinterpret_cast<Header*>(base);
+		}
+
+		// 初始化者写好全部字段后才把 state 置为就绪，其他进程拿到初始化锁、看到就绪时段内数据已完整
+		void initialize(const Layout& layout, size_t capacity, size_t transformThreshold)
+		{
+			new (header_) Header();
+			header_->state.store(1, std::memory_order_relaxed);
+			std::memcpy(header_->magic, kMagic, sizeof(header_->magic));
+			header_->version = kVersion;
+			header_->keySize = sizeof(Key);
+			header_->valueSize = sizeof(Value);
+			header_->nodeSize = sizeof(Node);
+			header_->totalBytes = layout.total;
+			header_->capacity = capacity;
+			header_->transformThreshold = transformThreshold;
+			header_->nodeCount = capacity * 2;
+			header_->bucketCount = capacity + 1;
+			header_->nodesOffset = layout.nodes;
+			header_->bucketsOffset = layout.buckets;
+			header_->lru.tableOffset = layout.lruTable;
+			header_->lru.tableMask = layout.lruMask;
+			header_->lfu.tableOffset = layout.lfuTable;
+			header_->lfu.tableMask = layout.lfuMask;
+			initMutex();
+			bindArrays();
+			format();
+			header_->state.store(2, std::memory_order_release);
+		}
+
+		// 段由另一个进程创建：校验魔数、版本与键值布局，确认段长覆盖全部数组后再使用
+		bool compatible()
+		{
+			if (std::memcmp(header_->magic, kMagic, sizeof(header_->magic)) != 0 || header_->version != kVersion
+				|| header_->keySize != sizeof(Key) || header_->valueSize != sizeof(Value) || header_->nodeSize != sizeof(Node)
+				|| header_->totalBytes > mappedBytes_) {
+				return false;
+			}
+			Layout layout = computeLayout(static_cast<size_t>(header_->capacity));
+			if (layout.total != header_->totalBytes) return false;
+			bindArrays();
+			return true;
+		}
+
+		void bindArrays()
+		{
+			nodes_ = reinterpret_cast<Node*>(base_ + header_->nodesOffset);
+			buckets_ = reinterpret_cast<FreqBucket*>(base_ + header_->bucketsOffset);
+		}
+
+		uint32_t* table(Part& p) { return reinterpret_cast<uint32_t*>(base_ + p.tableOffset); }
+
+		// 清空缓存并把容量恢复为均分，几何参数（数组位置与大小）不变。持锁进程崩溃后也用它重建
+		void format()
+		{
+			for (Part* p : { &header_->lru, &header_->lfu }) {
+				uint32_t* slots = table(*p);
+				for (uint32_t i = 0; i <= p->tableMask; ++i) slots[i] = kNil;
+			}
+			this->resetParts(static_cast<size_t>(header_->capacity));
+			this->resetFreeLists(static_cast<uint32_t>(header_->nodeCount), static_cast<uint32_t>(header_->bucketCount));
+		}
+
+		void recover()
+		{
+			format();
+			++header_->recoveries;
+		}
+
+		bool lockFailed()
+		{
+			broken_.store(true, std::memory_order_relaxed);
+			return false;
+		}
+
+		// ---- ArcIndexCore 的存储 ----
+
+		Node* nodes() { return nodes_; }
+		FreqBucket* buckets() { return buckets_; }
+		Part& lruPart() { return header_->lru; }
+		Part& lfuPart() { return header_->lfu; }
+		uint32_t& freeNodeHead() { return header_->freeNode; }
+		uint32_t& freeBucketHead() { return header_->freeBucket; }
+		uint64_t transformThreshold() const { return header_->transformThreshold; }
+
+		// ---- 每部分的哈希表 ----
+
+		uint32_t find(Part& p, const Key& key, uint64_t h)
+		{
+			uint32_t i = table(p)[h & p.tableMask];
+			while (i != kNil && !(nodes_[i].hash == h && equal_(nodes_[i].key, key))) i = nodes_[i].hashNext;
+			return i;
+		}
+
+		void linkIndex(Part& p, uint32_t i)
+		{
+			uint32_t& head = table(p)[nodes_[i].hash & p.tableMask];
+			nodes_[i].hashNext = head;
+			head = i;
+		}
+
+		void unlinkIndex(Part& p, uint32_t i)
+		{
+			uint32_t* link = &table(p)[nodes_[i].hash & p.tableMask];
+			while (*link != i) link = &nodes_[*link].hashNext;
+			*link = nodes_[i].hashNext;
+		}
+
+		static constexpr char kMagic[8] = { 'K', 'A', 'R', 'C', 'S', 'H', 'M', '1' };
+
+		Hash hash_;
+		KeyEqual equal_;
+		std::atomic<bool> broken_{ false };
+		char* base_ = nullptr;
+		Header* header_ = nullptr;
+		Node* nodes_ = nullptr;
+		FreqBucket* buckets_ = nullptr;
+		size_t mappedBytes_ = 0;
+	};
+
+	template<typename Key, typename Value, typename Hash, typename KeyEqual>
+	constexpr char ShmArcCache<Key, Value, Hash, KeyEqual>::kMagic[8];
+}
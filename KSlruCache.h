@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "KICachePolicy.h"
+#include "KCacheMutex.h"
+#include "KIndexList.h"
+
+namespace KArcCache {
+
+	// 分段 LRU（SLRU，Karedla 等 1994）：容量分为试用段与保护段，两段各是一条 LRU 链表。
+	// 新键进入试用段头部；试用段中的键再次被访问后升入保护段。保护段超额时，其最旧的条目降回试用段头部，
+	// 再获得一次机会。逐出总是从试用段尾部开始，只访问过一次的扫描键无法挤掉保护段里的工作集
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class KSlruCache : public KICachePolicy<Key, Value> {
+	public:
+		// protectedPercent：保护段占容量的百分比，常用 80%；容量大于 1 时试用段至少 1 个
+		explicit KSlruCache(size_t capacity, double protectedPercent = 80.0) :
+			capacity_(capacity),
+			protectedCapacity_(std::min(static_cast<size_t>(capacity * protectedPercent / 100.0), capacity ? capacity - 1 : 0))
+		{
+			index_.reserve(capacity);
+			pool_.reserve(capacity);
+		}
+
+		~KSlruCache() override = default;
+
+		// 写入已有的键也算一次访问
+		void put(Key key, Value value) override {
+			if (capacity_ == 0) return;
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = index_.find(key);
+			if (it != index_.end()) {
+				pool_[it->second].value = std::move(value);
+				touch(it->second);
+				return;
+			}
+
+			if (index_.size() >= capacity_) evict();
+			uint32_t i = pool_.allocate();
+			Entry& e = pool_[i];
+			e.key = key;
+			e.value = std::move(value);
+			e.isProtected = false;
+			probation_.pushFront(pool_, i);
+			index_.emplace(std::move(key), i);
+		}
+
+		bool get(Key key, Value& value) override {
+			std::lock_guard<CacheMutex> lk(mutex_);
+			auto it = index_.find(key);
+			if (it == index_.end()) return false;
+			value = pool_[it->second].value;
+			touch(it->second);
+			return true;
+		}
+
+		Value get(Key key) override {
+			Value value{};
+			get(key, value);
+			return value;
+		}
+
+		size_t getCapacity() const { return capacity_; }
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			appendLockStats(stats, "slru", mutex_);
+			return stats;
+		}
+
+		// 节点池按已分配槽位统计；没有幽灵条目与频次桶
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			namespace est = memory_estimate;
+			using Node = typename Pool::Node;
+			std::lock_guard<CacheMutex> lk(mutex_);
+			size_t resident = index_.size();
+			MemoryUsage usage;
+			usage.entries = resident;
+			usage.index = est::hashTable(index_);
+			usage.nodes = pool_.slots() * sizeof(Node) - resident * sizeof(Value);
+			usage.values = resident * sizeof(Value);
+			usage.exact = static_cast<bool>(valueSize);
+			if (valueSize) {
+				for (auto& kv : index_) usage.values += valueSize(pool_[kv.second].value);
+			}
+			return usage;
+		}
+
+	private:
+		struct Entry {
+			Key key{};
+			Value value{};
+			bool isProtected = false;
+		};
+
+		using Pool = IndexPool<Entry, 1>;
+
+		void touch(uint32_t i)
+		{
+			if (pool_[i].isProtected) {
+				protected_.moveToFront(pool_, i);
+				return;
+			}
+			probation_.remove(pool_, i);
+			if (protectedCapacity_ == 0) { // 容量为 1：没有保护段
+				probation_.pushFront(pool_, i);
+				return;
+			}
+			pool_[i].isProtected = true;
+			protected_.pushFront(pool_, i);
+			if (protected_.size() > protectedCapacity_) {
+				uint32_t demoted = protected_.back();
+				protected_.remove(pool_, demoted);
+				pool_[demoted].isProtected = false;
+				probation_.pushFront(pool_, demoted);
+			}
+		}
+
+		// 试用段为空（所有条目都在保护段）时才从保护段逐出
+		void evict()
+		{
+			uint32_t victim;
+			if (!probation_.empty()) {
+				victim = probation_.back();
+				probation_.remove(pool_, victim);
+			}
+			else {
+				victim = protected_.back();
+				protected_.remove(pool_, victim);
+			}
+			index_.erase(pool_[victim].key);
+			pool_.release(victim);
+		}
+
+		size_t capacity_;
+		size_t protectedCapacity_;
+		CacheMutex mutex_;
+		std::unordered_map<Key, uint32_t, Hash, KeyEqual> index_;
+		Pool pool_;
+		IndexList<0> probation_;  // 试用段，back 最旧
+		IndexList<0> protected_;  // 保护段，back 最旧
+	};
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "KHashedKey.h"
+
+namespace KArcCache {
+
+	// Space-Saving 重元素概要：最多跟踪 capacity 个键。未跟踪的键到来时顶替计数最小的键，并继承它的计数作为误差上界，
+	// 因此 count - error 是该键真实次数的下界，真实次数超过 total / capacity 的键一定在表中。
+	// 计数最小的键放在小根堆顶，每次 offer 为 O(log capacity)。非线程安全，由调用方加锁
+	template<typename Key, typename KeyEqual = std::equal_to<Key>>
+	class SpaceSaving {
+	public:
+		using KeyType = HashedKey<Key>;
+
+		struct Counter {
+			KeyType key;
+			uint64_t count;
+			uint64_t error;
+		};
+
+		explicit SpaceSaving(size_t capacity) : capacity_(std::max<size_t>(1, capacity)), total_(0)
+		{
+			counters_.reserve(capacity_);
+			index_.reserve(capacity_);
+		}
+
+		void offer(const KeyType& key, uint64_t weight = 1)
+		{
+			total_ += weight;
+			auto it = index_.find(key);
+			if (it != index_.end()) {
+				counters_[it->second].count += weight;
+				siftDown(it->second);
+				return;
+			}
+			if (counters_.size() < capacity_) {
+				counters_.push_back({ key, weight, 0 });
+				index_.emplace(key, counters_.size() - 1);
+				siftUp(counters_.size() - 1);
+				return;
+			}
+			Counter& victim = counters_[0];
+			index_.erase(victim.key);
+			victim.key = key;
+			victim.error = victim.count;
+			victim.count += weight;
+			index_.emplace(key, 0);
+			siftDown(0);
+		}
+
+		// 保证计数（count - error）不低于 threshold * total 的键，按计数从大到小，最多 limit 个
+		std::vector<Counter> heavyHitters(double threshold, size_t limit) const
+		{
+			uint64_t floor = static_cast<uint64_t>(threshold * static_cast<double>(total_));
+			std::vector<Counter> result;
+			for (const Counter& c : counters_) {
+				if (c.count - c.error >= std::max<uint64_t>(floor, 1)) result.push_back(c);
+			}
+			std::sort(result.begin(), result.end(), [](const Counter& a, const Counter& b) { return a.count > b.count; });
+			if (result.size() > limit) result.resize(limit);
+			return result;
+		}
+
+		// 计数与误差减半，让概要跟上热点的变化；减半保持大小顺序，堆无需重建
+		void decay()
+		{
+			for (Counter& c : counters_) {
+				c.count >>= 1;
+				c.error >>= 1;
+			}
+			total_ >>= 1;
+		}
+
+		uint64_t total() const { return total_; }
+		size_t size() const { return counters_.size(); }
+
+	private:
+		void swapAt(size_t a, size_t b)
+		{
+			std::swap(counters_[a], counters_[b]);
+			index_[counters_[a].key] = a;
+			index_[counters_[b].key] = b;
+		}
+
+		void siftUp(size_t i)
+		{
+			while (i > 0) {
+				size_t parent = (i - 1) / 2;
+				if (counters_[parent].count <= counters_[i].count) break;
+				swapAt(i, parent);
+				i = parent;
+			}
+		}
+
+		void siftDown(size_t i)
+		{
+			for (;;) {
+				size_t smallest = i;
+				size_t l = 2 * i + 1, r = l + 1;
+				if (l < counters_.size() && counters_[l].count < counters_[smallest].count) smallest = l;
+				if (r < counters_.size() && counters_[r].count < counters_[smallest].count) smallest = r;
+				if (smallest == i) return;
+				swapAt(i, smallest);
+				i = smallest;
+			}
+		}
+
+		size_t capacity_;
+		uint64_t total_;
+		std::vector<Counter> counters_;
+		HashedMap<Key, size_t, KeyEqual> index_;
+	};
+}
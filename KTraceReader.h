@@ -0,0 +1,326 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KTraceSimulator.h"
+#include "KAccessRecorder.h"
+
+namespace KArcCache {
+
+	// 支持的公开 trace 格式（每行一条请求）：
+	//   Arc     : ARC 论文附带的 trace（OLTP、P1-P14 等），"起始块 块数 忽略 请求号"，块为 512 字节
+	//   Spc     : UMass/SPC（Financial、WebSearch），"ASU,LBA,Size,Opcode,Timestamp"，LBA 以 512 字节扇区计、Size 以字节计
+	//   Msr     : MSR Cambridge，"Timestamp,Hostname,DiskNumber,Type,Offset,Size,ResponseTime"，Offset/Size 以字节计
+	//   Twitter : Twemcache 集群 trace，"timestamp,key,keySize,valueSize,clientId,operation,ttl"
+	//   Wikipedia : Wikipedia CDN，空白分隔 "timestamp id size [...]"
+	enum class TraceFormat : uint8_t { Arc, Spc, Msr, Twitter, Wikipedia };
+
+	// 流式 trace 解析：一次只持有一行和一个待展开的块区间，内存与 trace 长度无关。
+	// 块 trace 的一条请求按 blockSize 展开成逐块访问，键为 (设备 << 48) | 块号；对象 trace 的字符串键取 FNV-1a 哈希。
+	// 读请求与对象 trace 的 get 产生 Access（未命中则回填），写请求与 set 类命令产生 Put，delete 等其余命令跳过
+	class TraceReader {
+	public:
+		using Key = uint64_t;
+
+		TraceReader(std::istream& in, TraceFormat format, uint32_t blockSize = 4096) :
+			in_(in),
+			format_(format),
+			blockSize_(blockSize ? blockSize : 1),
+			pendingNext_(0),
+			pendingLeft_(0),
+			pendingType_(TraceOpType::Access),
+			lines_(0),
+			skipped_(0) {}
+
+		// 取下一个操作，trace 结束时返回 false
+		bool next(TraceOp<Key>& op)
+		{
+			while (pendingLeft_ == 0) {
+				if (!std::getline(in_, line_)) return false;
+				++lines_;
+				if (!parseLine()) ++skipped_;
+			}
+			op.key = pendingNext_++;
+			--pendingLeft_;
+			op.type = pendingType_;
+			return true;
+		}
+
+		// 按 TraceSimulator::TraceSource 的约定填充一块
+		bool fill(std::vector<TraceOp<Key>>& chunk, size_t maxOps)
+		{
+			TraceOp<Key> op;
+			while (chunk.size() < maxOps) {
+				if (!next(op)) return false;
+				chunk.push_back(op);
+			}
+			return true;
+		}
+
+		uint64_t lines() const { return lines_; }
+		uint64_t skipped() const { return skipped_; } // 格式错误、表头或不支持的命令
+
+	private:
+		static constexpr uint64_t kBlockMask = (1ull << 48) - 1;
+		static constexpr uint64_t kSectorSize = 512;
+
+		// 按分隔符切分当前行，字段指针指向 line_ 内部；whitespace 为 true 时连续空白视为一个分隔符
+		size_t split(char delim, bool whitespace)
+		{
+			fields_.clear();
+			char* p = &line_[0];
+			char* end = p + line_.size();
+			if (end > p && end[-1] == '\r') *--end = '\0'; // 兼容 CRLF
+			while (p < end) {
+				if (whitespace) {
+					while (p < end && (*p == ' ' || *p == '\t')) ++p;
+					if (p == end) break;
+				}
+				fields_.push_back(p);
+				while (p < end && (whitespace ? (*p != ' ' && *p != '\t') : *p != delim)) ++p;
+				if (p < end) *p++ = '\0';
+			}
+			return fields_.size();
+		}
+
+		static bool parseUint(const char* s, uint64_t& out)
+		{
+			if (*s < '0' || *s > '9') return false;
+			char* end;
+			out = std::strtoull(s, &end, 10);
+			return *end == '\0';
+		}
+
+		static uint64_t fnv1a(const char* s)
+		{
+			uint64_t h = 0xcbf29ce484222325ull;
+			while (*s) {
+				h ^= static_cast<unsigned char>(*s++);
+				h *= 0x100000001b3ull;
+			}
+			return h;
+		}
+
+		// 数字 id 直接作键，其余（匿名化的字符串键、URL 哈希）取 FNV-1a，与平台的 std::hash 无关
+		static Key objectKey(const char* s)
+		{
+			uint64_t id;
+			return parseUint(s, id) ? id : fnv1a(s);
+		}
+
+		void setBlocks(uint64_t device, uint64_t first, uint64_t count, TraceOpType type)
+		{
+			uint64_t base = (device & 0xffff) << 48;
+			pendingNext_ = base | (first & kBlockMask);
+			pendingLeft_ = count;
+			pendingType_ = type;
+		}
+
+		// 字节区间 [offset, offset + size) 覆盖的所有 blockSize 块
+		void setByteRange(uint64_t device, uint64_t offset, uint64_t size, TraceOpType type)
+		{
+			uint64_t first = offset / blockSize_;
+			uint64_t last = (offset + (size ? size : 1) - 1) / blockSize_;
+			setBlocks(device, first, last - first + 1, type);
+		}
+
+		void setObject(Key key, TraceOpType type)
+		{
+			pendingNext_ = key;
+			pendingLeft_ = 1;
+			pendingType_ = type;
+		}
+
+		bool parseLine()
+		{
+			pendingLeft_ = 0;
+			uint64_t a, b, c;
+			switch (format_) {
+			case TraceFormat::Arc:
+				if (split(' ', true) < 2 || !parseUint(fields_[0], a) || !parseUint(fields_[1], b) || b == 0) return false;
+				setBlocks(0, a, b, TraceOpType::Access);
+				return true;
+			case TraceFormat::Spc: {
+				if (split(',', false) < 4 || !parseUint(fields_[0], a) || !parseUint(fields_[1], b) || !parseUint(fields_[2], c)) return false;
+				char opcode = fields_[3][0];
+				if (opcode != 'r' && opcode != 'R' && opcode != 'w' && opcode != 'W') return false;
+				setByteRange(a, b * kSectorSize, c, (opcode == 'w' || opcode == 'W') ? TraceOpType::Put : TraceOpType::Access);
+				return true;
+			}
+			case TraceFormat::Msr: {
+				if (split(',', false) < 6 || !parseUint(fields_[2], a) || !parseUint(fields_[4], b) || !parseUint(fields_[5], c)) return false;
+				std::string type = fields_[3];
+				if (type != "Read" && type != "Write") return false;
+				// 设备号由主机名与盘号组合，不同服务器的同号磁盘互不混淆
+				setByteRange(fnv1a(fields_[1]) * 31 + a, b, c, type == "Write" ? TraceOpType::Put : TraceOpType::Access);
+				return true;
+			}
+			case TraceFormat::Twitter: {
+				if (split(',', false) < 6 || fields_[1][0] == '\0') return false;
+				std::string op = fields_[5];
+				if (op == "get" || op == "gets") {
+					setObject(fnv1a(fields_[1]), TraceOpType::Access);
+				}
+				else if (op == "set" || op == "add" || op == "replace" || op == "cas" ||
+					op == "append" || op == "prepend" || op == "incr" || op == "decr") {
+					setObject(fnv1a(fields_[1]), TraceOpType::Put);
+				}
+				else {
+					return false; // delete 等无法映射到 KICachePolicy 的命令
+				}
+				return true;
+			}
+			case TraceFormat::Wikipedia:
+				if (split(' ', true) < 2) return false;
+				setObject(objectKey(fields_[1]), TraceOpType::Access);
+				return true;
+			}
+			return false;
+		}
+
+		std::istream& in_;
+		TraceFormat format_;
+		uint64_t blockSize_;
+		std::string line_;
+		std::vector<char*> fields_;
+		uint64_t pendingNext_; // 当前请求尚未展开的部分：从 pendingNext_ 起的 pendingLeft_ 个键
+		uint64_t pendingLeft_;
+		TraceOpType pendingType_;
+		uint64_t lines_;
+		uint64_t skipped_;
+	};
+
+	// 读取 AccessRecorder 录制的二进制 trace（格式见 trace_format）。next(TraceOp&) 与 TraceReader 接口一致：
+	// 录下的 Get 作为 Access 回放（未命中则回填），Put 仍为 Put；next(AccessRecord&) 给出完整记录
+	class RecordedTraceReader {
+	public:
+		using Key = uint64_t;
+
+		explicit RecordedTraceReader(std::istream& in) :
+			in_(*in.rdbuf()),
+			sampleRate_(0.0),
+			timestamp_(0),
+			records_(0),
+			ok_(readHeader()) {}
+
+		// 文件头是否有效
+		bool ok() const { return ok_; }
+
+		double sampleRate() const { return sampleRate_; }
+
+		// 文件结束或记录不完整时返回 false
+		bool next(AccessRecord& r)
+		{
+			if (!ok_) return false;
+			int flags = in_.sbumpc();
+			uint64_t delta, size;
+			if (flags == std::char_traits<char>::eof() || !getVarint(delta) || !getFixed(r.keyHash, 8) || !getVarint(size)) return false;
+			timestamp_ += static_cast<uint64_t>(trace_format::unzigzag(delta));
+			r.timestamp = timestamp_;
+			r.size = static_cast<uint32_t>(size);
+			r.op = static_cast<TraceOpType>(flags & 3);
+			r.hit = (flags & 4) != 0;
+			++records_;
+			return true;
+		}
+
+		bool next(TraceOp<Key>& op)
+		{
+			AccessRecord r;
+			if (!next(r)) return false;
+			op.key = r.keyHash;
+			op.type = r.op == TraceOpType::Put ? TraceOpType::Put : TraceOpType::Access;
+			return true;
+		}
+
+		// 按 TraceSimulator::TraceSource 的约定填充一块
+		bool fill(std::vector<TraceOp<Key>>& chunk, size_t maxOps)
+		{
+			TraceOp<Key> op;
+			while (chunk.size() < maxOps) {
+				if (!next(op)) return false;
+				chunk.push_back(op);
+			}
+			return true;
+		}
+
+		uint64_t records() const { return records_; }
+
+	private:
+		bool readHeader()
+		{
+			char magic[sizeof(trace_format::kMagic)];
+			uint64_t version, bits;
+			if (in_.sgetn(magic, sizeof(magic)) != static_cast<std::streamsize>(sizeof(magic)) ||
+				std::memcmp(magic, trace_format::kMagic, sizeof(magic)) != 0 ||
+				!getFixed(version, 4) || version != trace_format::kVersion || !getFixed(bits, 8)) {
+				return false;
+			}
+			std::memcpy(&sampleRate_, &bits, sizeof(bits));
+			return true;
+		}
+
+		bool getFixed(uint64_t& v, size_t bytes)
+		{
+			unsigned char buf[8];
+			if (in_.sgetn(reinterpret_cast<char*>(buf), static_cast<std::streamsize>(bytes)) != static_cast<std::streamsize>(bytes)) return false;
+			v = 0;
+			for (size_t i = 0; i < bytes; ++i) v |= static_cast<uint64_t>(buf[i]) << (8 * i);
+			return true;
+		}
+
+		bool getVarint(uint64_t& v)
+		{
+			v = 0;
+			for (int shift = 0; shift < 64; shift += 7) {
+				int c = in_.sbumpc();
+				if (c == std::char_traits<char>::eof()) return false;
+				v |= static_cast<uint64_t>(c & 0x7f) << shift;
+				if (!(c & 0x80)) return true;
+			}
+			return false;
+		}
+
+		std::streambuf& in_;
+		double sampleRate_;
+		uint64_t timestamp_;
+		uint64_t records_;
+		bool ok_;
+	};
+
+	struct TraceReplayStats {
+		uint64_t gets = 0;
+		uint64_t hits = 0;
+		uint64_t puts = 0;
+		double hitRate() const { return gets ? hits * 100.0 / gets : 0.0; }
+	};
+
+	// 把 trace 直接流式回放进单个缓存：Access 未命中时回填 fill，与按需分页的缓存语义一致。
+	// Reader 为 TraceReader 或 RecordedTraceReader
+	template<typename Reader, typename Value>
+	TraceReplayStats replayTrace(Reader& reader, KICachePolicy<typename Reader::Key, Value>& cache, const Value& fill = Value{})
+	{
+		TraceReplayStats stats;
+		TraceOp<typename Reader::Key> op;
+		Value value{};
+		while (reader.next(op)) {
+			if (op.type == TraceOpType::Put) {
+				++stats.puts;
+				cache.put(op.key, fill);
+				continue;
+			}
+			++stats.gets;
+			if (cache.get(op.key, value)) {
+				++stats.hits;
+			}
+			else if (op.type == TraceOpType::Access) {
+				cache.put(op.key, fill);
+			}
+		}
+		return stats;
+	}
+}
@@ -0,0 +1,204 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "KICachePolicy.h"
+
+namespace KArcCache {
+
+	// Access 是真实 trace 里的一次引用：读未命中时按需回填（put），Get 则只读不回填
+	enum class TraceOpType : uint8_t { Get, Put, Access };
+
+	template<typename Key>
+	struct TraceOp {
+		Key key;
+		TraceOpType type;
+	};
+
+	// 并行多策略回放：trace 只解码一次，切成只读块共享给所有配置。
+	// 配置按轮转分给 min(线程数, 配置数) 个工作线程，每个线程对自己的一组配置逐块回放；
+	// 解码线程最多领先最慢的工作线程 maxChunksInFlight 块，因此内存有界，总耗时约等于读一遍 trace。
+	// 策略工厂、策略本身或 trace 源抛出异常时，所有线程尽快停下，run 在全部线程 join 之后重新抛出第一个异常
+	template<typename Key, typename Value>
+	class TraceSimulator {
+	public:
+		using Policy = KICachePolicy<Key, Value>;
+		using PolicyFactory = std::function<std::unique_ptr<Policy>()>;
+		using Chunk = std::vector<TraceOp<Key>>;
+		// 填充下一块，trace 结束时返回 false（最后一块可与 false 一起返回）
+		using TraceSource = std::function<bool(Chunk&)>;
+
+		struct Result {
+			std::string name;
+			size_t capacity;
+			uint64_t gets;
+			uint64_t hits;
+			double hitRate() const { return gets ? hits * 100.0 / gets : 0.0; }
+		};
+
+		explicit TraceSimulator(size_t threads = 0, size_t chunkSize = 1 << 16, size_t maxChunksInFlight = 8) :
+			threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+			chunkSize_(std::max<size_t>(chunkSize, 1)),
+			maxChunksInFlight_(std::max<size_t>(maxChunksInFlight, 1)) {}
+
+		// factory 在工作线程内调用，策略对象只被该线程访问
+		void addConfig(std::string name, size_t capacity, PolicyFactory factory)
+		{
+			configs_.push_back({ std::move(name), capacity, std::move(factory) });
+		}
+
+		std::vector<Result> run(const TraceSource& source)
+		{
+			std::vector<Result> results(configs_.size());
+			if (configs_.empty()) return results;
+
+			size_t workers = std::min(threads_, configs_.size());
+			Shared shared(workers);
+			std::vector<std::thread> pool;
+			pool.reserve(workers);
+			for (size_t w = 0; w < workers; ++w) {
+				pool.emplace_back([this, &shared, &results, w, workers] { worker(shared, results, w, workers); });
+			}
+
+			try {
+				bool more = true;
+				while (more) {
+					auto chunk = std::make_shared<Chunk>();
+					chunk->reserve(chunkSize_);
+					more = source(*chunk);
+					if (chunk->empty()) continue;
+
+					std::unique_lock<std::mutex> lock(shared.mutex);
+					shared.producerCv.wait(lock, [&] { return shared.chunks.size() < maxChunksInFlight_ || shared.error; });
+					if (shared.error) break;
+					shared.chunks.push_back(std::move(chunk));
+					shared.consumerCv.notify_all();
+				}
+			}
+			catch (...) {
+				shared.fail(std::current_exception());
+			}
+			{
+				std::lock_guard<std::mutex> lock(shared.mutex);
+				shared.finished = true;
+			}
+			shared.consumerCv.notify_all();
+			for (auto& t : pool) t.join();
+			if (shared.error) std::rethrow_exception(shared.error);
+			return results;
+		}
+
+		// 便捷接口：回放内存中已生成好的操作序列
+		std::vector<Result> run(const std::vector<TraceOp<Key>>& trace)
+		{
+			size_t pos = 0;
+			return run([&](Chunk& chunk) {
+				size_t end = std::min(trace.size(), pos + chunkSize_);
+				chunk.assign(trace.begin() + pos, trace.begin() + end);
+				pos = end;
+				return pos < trace.size();
+			});
+		}
+
+	private:
+		struct Config {
+			std::string name;
+			size_t capacity;
+			PolicyFactory factory;
+		};
+
+		struct Shared {
+			explicit Shared(size_t workers) : consumed(workers, 0), base(0), finished(false) {}
+			std::mutex mutex;
+			std::condition_variable producerCv;
+			std::condition_variable consumerCv;
+			std::deque<std::shared_ptr<const Chunk>> chunks; // chunks[0] 的全局序号为 base
+			std::vector<uint64_t> consumed;                  // 每个工作线程已处理的块数
+			uint64_t base;
+			bool finished;
+			std::exception_ptr error;                        // 第一个异常；非空时解码与回放都停止
+
+			void fail(std::exception_ptr e)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if (!error) error = std::move(e);
+				}
+				producerCv.notify_all();
+				consumerCv.notify_all();
+			}
+		};
+
+		// 异常不能逃出线程函数，否则进程直接 terminate：记下后交给 run 重新抛出
+		void worker(Shared& shared, std::vector<Result>& results, size_t self, size_t workers)
+		{
+			try {
+				replay(shared, results, self, workers);
+			}
+			catch (...) {
+				shared.fail(std::current_exception());
+			}
+		}
+
+		void replay(Shared& shared, std::vector<Result>& results, size_t self, size_t workers)
+		{
+			std::vector<size_t> mine;
+			std::vector<std::unique_ptr<Policy>> policies;
+			for (size_t i = self; i < configs_.size(); i += workers) {
+				mine.push_back(i);
+				policies.push_back(configs_[i].factory());
+				results[i] = { configs_[i].name, configs_[i].capacity, 0, 0 };
+			}
+
+			uint64_t next = 0;
+			Value value{};
+			while (true) {
+				std::shared_ptr<const Chunk> chunk;
+				{
+					std::unique_lock<std::mutex> lock(shared.mutex);
+					shared.consumerCv.wait(lock, [&] { return next < shared.base + shared.chunks.size() || shared.finished || shared.error; });
+					if (shared.error || next >= shared.base + shared.chunks.size()) break;
+					chunk = shared.chunks[next - shared.base];
+				}
+
+				for (size_t j = 0; j < mine.size(); ++j) {
+					Policy& policy = *policies[j];
+					Result& result = results[mine[j]];
+					for (const auto& op : *chunk) {
+						if (op.type == TraceOpType::Put) {
+							policy.put(op.key, value);
+						}
+						else {
+							++result.gets;
+							if (policy.get(op.key, value)) ++result.hits;
+							else if (op.type == TraceOpType::Access) policy.put(op.key, value);
+						}
+					}
+				}
+
+				std::lock_guard<std::mutex> lock(shared.mutex);
+				shared.consumed[self] = ++next;
+				// 所有线程都处理完的块从队头释放
+				uint64_t slowest = *std::min_element(shared.consumed.begin(), shared.consumed.end());
+				while (shared.base < slowest) {
+					shared.chunks.pop_front();
+					++shared.base;
+				}
+				shared.producerCv.notify_one();
+			}
+		}
+
+		size_t threads_;
+		size_t chunkSize_;
+		size_t maxChunksInFlight_;
+		std::vector<Config> configs_;
+	};
+}
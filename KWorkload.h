@@ -0,0 +1,261 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "KArcSampler.h"
+#include "KTraceSimulator.h"
+
+namespace KArcCache {
+namespace workload {
+
+	// 确定性随机数：splitmix64，同一种子在任何平台、任何标准库下都产生相同序列
+	class Rng {
+	public:
+		explicit Rng(uint64_t seed) : state_(seed) {}
+
+		uint64_t next()
+		{
+			uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			return z ^ (z >> 31);
+		}
+
+		// [0, n) 上的无偏整数（拒绝采样），替代有偏的 gen() % n
+		uint64_t below(uint64_t n)
+		{
+			if (n <= 1) return 0;
+			uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+			uint64_t r;
+			do { r = next(); } while (r >= limit);
+			return r % n;
+		}
+
+		double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+		bool percent(int p) { return below(100) < static_cast<uint64_t>(p); }
+
+	private:
+		uint64_t state_;
+	};
+
+	// YCSB 的 Zipfian 生成器（Gray 等人的方法）：构造时 O(n) 计算 zeta，之后每次 O(1)。
+	// theta 越大越倾斜，0 退化为均匀分布；rank 0 最热
+	class Zipfian {
+	public:
+		// theta 取 [0, 1)，YCSB 默认 0.99
+		Zipfian(uint64_t items, double theta) :
+			items_(items ? items : 1),
+			theta_(theta < 1.0 ? theta : 0.9999),
+			zetan_(zeta(items_, theta_)),
+			alpha_(1.0 / (1.0 - theta_)),
+			eta_((1.0 - std::pow(2.0 / items_, 1.0 - theta_)) / (1.0 - zeta(2, theta_) / zetan_)) {}
+
+		uint64_t next(Rng& rng) const
+		{
+			if (theta_ <= 0.0) return rng.below(items_);
+			double u = rng.uniform();
+			double uz = u * zetan_;
+			if (uz < 1.0) return 0;
+			if (uz < 1.0 + std::pow(0.5, theta_)) return 1;
+			uint64_t rank = static_cast<uint64_t>(items_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+			return rank < items_ ? rank : items_ - 1;
+		}
+
+		uint64_t items() const { return items_; }
+
+	private:
+		static double zeta(uint64_t n, double theta)
+		{
+			double sum = 0.0;
+			for (uint64_t i = 1; i <= n; ++i) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+			return sum;
+		}
+
+		uint64_t items_;
+		double theta_;
+		double zetan_;
+		double alpha_;
+		double eta_;
+	};
+
+	template<typename Key>
+	using Ops = std::vector<TraceOp<Key>>;
+
+	template<typename Key>
+	inline TraceOp<Key> makeOp(uint64_t key, bool isPut)
+	{
+		return { static_cast<Key>(key), isPut ? TraceOpType::Put : TraceOpType::Get };
+	}
+
+	template<typename Key = int>
+	Ops<Key> uniform(size_t ops, uint64_t keys, int putPercent, uint64_t seed)
+	{
+		Rng rng(seed);
+		Ops<Key> out;
+		out.reserve(ops);
+		for (size_t i = 0; i < ops; ++i) {
+			bool isPut = rng.percent(putPercent);
+			out.push_back(makeOp<Key>(rng.below(keys), isPut));
+		}
+		return out;
+	}
+
+	template<typename Key = int>
+	Ops<Key> zipfian(size_t ops, uint64_t keys, double theta, int putPercent, uint64_t seed)
+	{
+		Rng rng(seed);
+		Zipfian zipf(keys, theta);
+		Ops<Key> out;
+		out.reserve(ops);
+		for (size_t i = 0; i < ops; ++i) {
+			bool isPut = rng.percent(putPercent);
+			out.push_back(makeOp<Key>(zipf.next(rng), isPut));
+		}
+		return out;
+	}
+
+	// 打散的 Zipfian：热度分布不变，但热点键散布在整个键空间，而不是集中在小编号上
+	template<typename Key = int>
+	Ops<Key> scrambledZipfian(size_t ops, uint64_t keys, double theta, int putPercent, uint64_t seed)
+	{
+		Rng rng(seed);
+		Zipfian zipf(keys, theta);
+		Ops<Key> out;
+		out.reserve(ops);
+		for (size_t i = 0; i < ops; ++i) {
+			bool isPut = rng.percent(putPercent);
+			out.push_back(makeOp<Key>(mixHash(zipf.next(rng)) % zipf.items(), isPut));
+		}
+		return out;
+	}
+
+	// 顺序扫描：键从 start 起单调递增、永不重复
+	template<typename Key = int>
+	Ops<Key> sequentialScan(size_t ops, uint64_t start, int putPercent, uint64_t seed)
+	{
+		Rng rng(seed);
+		Ops<Key> out;
+		out.reserve(ops);
+		for (size_t i = 0; i < ops; ++i) {
+			bool isPut = rng.percent(putPercent);
+			out.push_back(makeOp<Key>(start + i, isPut));
+		}
+		return out;
+	}
+
+	// 循环访问：0..loopSize-1 反复顺序遍历
+	template<typename Key = int>
+	Ops<Key> looping(size_t ops, uint64_t loopSize, int putPercent, uint64_t seed)
+	{
+		Rng rng(seed);
+		Ops<Key> out;
+		out.reserve(ops);
+		for (size_t i = 0; i < ops; ++i) {
+			bool isPut = rng.percent(putPercent);
+			out.push_back(makeOp<Key>(i % (loopSize ? loopSize : 1), isPut));
+		}
+		return out;
+	}
+
+	// 热点：hotPercent 的访问落在 [0, hotKeys)，其余落在 [hotKeys, hotKeys + coldKeys)
+	template<typename Key = int>
+	Ops<Key> hotspot(size_t ops, uint64_t hotKeys, uint64_t coldKeys, int hotPercent, int putPercent, uint64_t seed)
+	{
+		Rng rng(seed);
+		Ops<Key> out;
+		out.reserve(ops);
+		for (size_t i = 0; i < ops; ++i) {
+			bool isPut = rng.percent(putPercent);
+			uint64_t key = rng.percent(hotPercent) ? rng.below(hotKeys) : hotKeys + rng.below(coldKeys);
+			out.push_back(makeOp<Key>(key, isPut));
+		}
+		return out;
+	}
+
+	// 阶段切换：把各阶段依次拼接
+	template<typename Key>
+	Ops<Key> phaseShift(const std::vector<Ops<Key>>& phases)
+	{
+		size_t total = 0;
+		for (const auto& p : phases) total += p.size();
+		Ops<Key> out;
+		out.reserve(total);
+		for (const auto& p : phases) out.insert(out.end(), p.begin(), p.end());
+		return out;
+	}
+
+	enum class Ycsb { A, B, C, D, E, F };
+
+	// YCSB 核心负载。先假定 records 条记录已装载，update/insert 对应 Put，read 对应 Get：
+	// A 50% 读 / 50% 更新；B 95/5；C 只读；D 95% 读最新 / 5% 插入；
+	// E 95% 短范围扫描（1..maxScan 个连续 Get）/ 5% 插入；F 50% 读 / 50% 读-改-写（Get + Put）
+	template<typename Key = int>
+	Ops<Key> ycsb(Ycsb type, size_t ops, uint64_t records, uint64_t seed, double theta = 0.99, uint64_t maxScan = 100)
+	{
+		Rng rng(seed);
+		Zipfian zipf(records, theta);
+		uint64_t inserted = records;
+		auto requestKey = [&]() { return mixHash(zipf.next(rng)) % records; };
+
+		Ops<Key> out;
+		out.reserve(ops);
+		while (out.size() < ops) {
+			switch (type) {
+			case Ycsb::A:
+				out.push_back(makeOp<Key>(requestKey(), rng.percent(50)));
+				break;
+			case Ycsb::B:
+				out.push_back(makeOp<Key>(requestKey(), rng.percent(5)));
+				break;
+			case Ycsb::C:
+				out.push_back(makeOp<Key>(requestKey(), false));
+				break;
+			case Ycsb::D:
+				if (rng.percent(5)) {
+					out.push_back(makeOp<Key>(inserted++, true));
+				}
+				else {
+					// 最新分布：越新插入的记录越热
+					uint64_t back = zipf.next(rng) % inserted;
+					out.push_back(makeOp<Key>(inserted - 1 - back, false));
+				}
+				break;
+			case Ycsb::E:
+				if (rng.percent(5)) {
+					out.push_back(makeOp<Key>(inserted++, true));
+				}
+				else {
+					uint64_t start = requestKey();
+					uint64_t length = 1 + rng.below(maxScan);
+					for (uint64_t i = 0; i < length && out.size() < ops; ++i) {
+						out.push_back(makeOp<Key>((start + i) % inserted, false));
+					}
+				}
+				break;
+			case Ycsb::F:
+				if (rng.percent(50)) {
+					uint64_t key = requestKey();
+					out.push_back(makeOp<Key>(key, false));
+					if (out.size() < ops) out.push_back(makeOp<Key>(key, true));
+				}
+				else {
+					out.push_back(makeOp<Key>(requestKey(), false));
+				}
+				break;
+			}
+		}
+		return out;
+	}
+
+	// 预先格式化每个键的值，避免计时循环里调用 std::to_string
+	inline std::vector<std::string> makeValues(uint64_t keys, const std::string& prefix)
+	{
+		std::vector<std::string> values;
+		values.reserve(keys);
+		for (uint64_t k = 0; k < keys; ++k) values.push_back(prefix + std::to_string(k));
+		return values;
+	}
+}
+}
@@ -1,11 +1,14 @@
+#pragma once
 #include <memory>
 #include <unordered_map>
-#include <mutex>
 #include <climits>
 #include <cstring>
+#include <functional>
 #include "KICachePolicy.h"
+#include "KCacheMutex.h"
 namespace KArcCache {
-    template<typename Key, typename Value> class KLfuCache;
+    // Hash / KeyEqual 作用于节点表，含义与 std::unordered_map 的同名参数相同
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>> class KLfuCache;
 
     template<typename Key, typename Value>
     class FreqList {
@@ -54,18 +57,18 @@ namespace KArcCache {
         }
         NodePtr getFirstNode() const { return head_->next; }
 
-        friend class KLfuCache<Key, Value>;
+        template<typename K, typename V, typename H, typename E> friend class KLfuCache;
         using Node = node;
         using NodePtrAlias = NodePtr;
     };
 
-    template <typename Key, typename Value>
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
     class KLfuCache : public KICachePolicy<Key, Value> {
     public:
         using List = FreqList<Key, Value>;
         using Node = typename List::Node;
         using NodePtr = std::shared_ptr<Node>;
-        using NodeMap = std::unordered_map<Key, NodePtr>;
+        using NodeMap = std::unordered_map<Key, NodePtr, Hash, KeyEqual>;
 
     private:
         int  capacity_;
@@ -74,7 +77,7 @@ namespace KArcCache {
         long long curTotalNum_;
         int  curAverageNum_;
 
-        std::mutex mutex_;
+        CacheMutex mutex_;
         NodeMap nodeMap_;
         std::unordered_map<int, List*> freqToFreqList_;
 
@@ -117,7 +120,7 @@ namespace KArcCache {
         //put 命中老键：不涨频次，只在同频次桶内移到尾部
         void put(Key key, Value value) override {
             if (capacity_ == 0) return;
-            std::lock_guard<std::mutex> lk(mutex_);
+            std::lock_guard<CacheMutex> lk(mutex_);
             auto it = nodeMap_.find(key);
             if (it != nodeMap_.end()) {
                 auto node = it->second;
@@ -131,7 +134,7 @@ namespace KArcCache {
 
         bool get(Key key, Value& value) override {
             if (capacity_ == 0) return false;
-            std::lock_guard<std::mutex> lk(mutex_);
+            std::lock_guard<CacheMutex> lk(mutex_);
             auto it = nodeMap_.find(key);
             bool hit = false;
             if (it != nodeMap_.end()) {
@@ -148,8 +151,32 @@ namespace KArcCache {
             return v;
         }
 
+        std::vector<NamedLockStats> lockStats() override {
+            std::vector<NamedLockStats> stats;
+            appendLockStats(stats, "lfu", mutex_);
+            return stats;
+        }
+
+        MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+            namespace est = memory_estimate;
+            std::lock_guard<CacheMutex> lk(mutex_);
+            MemoryUsage usage;
+            usage.entries = nodeMap_.size();
+            usage.index = est::hashTable(nodeMap_);
+            usage.nodes = nodeMap_.size() * (est::sharedNode<Node>() - sizeof(Value));
+            // 每个频次一个 new 出来的 FreqList，各带两个哨兵节点
+            usage.freqBuckets = est::hashTable(freqToFreqList_) +
+                freqToFreqList_.size() * (sizeof(List) + 2 * est::sharedNode<Node>());
+            usage.values = nodeMap_.size() * sizeof(Value);
+            usage.exact = static_cast<bool>(valueSize);
+            if (valueSize) {
+                for (auto& kv : nodeMap_) usage.values += valueSize(kv.second->value_);
+            }
+            return usage;
+        }
+
         void purge() {
-            std::lock_guard<std::mutex> lk(mutex_);
+            std::lock_guard<CacheMutex> lk(mutex_);
             nodeMap_.clear();
             for (auto& kv : freqToFreqList_) delete kv.second;
             freqToFreqList_.clear();
@@ -159,8 +186,8 @@ namespace KArcCache {
         }
     };
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::putInternal(const Key& key, const Value& value) {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::putInternal(const Key& key, const Value& value) {
             if (nodeMap_.size() == static_cast<size_t>(capacity_)) {
                 kickOut();
             }
@@ -170,8 +197,8 @@ namespace KArcCache {
             if (minFreq_ > 1) minFreq_ = 1;
         }
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::getInternal(const NodePtr& node, Value& value) {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::getInternal(const NodePtr& node, Value& value) {
             value = node->value_;
             int oldf = node->freq_;
             removeFromFreqList(node);
@@ -186,8 +213,8 @@ namespace KArcCache {
             //addFreqNum();
         }
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::kickOut() {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::kickOut() {
             if (nodeMap_.empty()) return;
 
             // 若 minFreq_ 桶为空，重新定位到非空最小桶
@@ -207,16 +234,16 @@ namespace KArcCache {
         }
 
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::removeFromFreqList(const NodePtr& node) {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::removeFromFreqList(const NodePtr& node) {
             if (!node) return;
             int f = node->freq_;
             auto it = freqToFreqList_.find(f);
             if (it != freqToFreqList_.end()) it->second->removeNode(node);
         }
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::addToFreqList(const NodePtr& node) {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::addToFreqList(const NodePtr& node) {
             if (!node) return;
             int f = node->freq_;
             List* lst = ensureList(f);
@@ -224,16 +251,16 @@ namespace KArcCache {
             lst->addNode(node);
         }
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::addFreqNum() {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::addFreqNum() {
             ++curTotalNum_;
             if (nodeMap_.empty()) curAverageNum_ = 0;
             else curAverageNum_ = static_cast<int>(curTotalNum_ / static_cast<long long>(nodeMap_.size()));
             if (curAverageNum_ > maxAverageNum_) handleOverMaxAverageNum();
         }
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::decreaseFreqNum(int num) {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::decreaseFreqNum(int num) {
             if (num <= 0) return;
             curTotalNum_ -= num;
             if (curTotalNum_ < 0) curTotalNum_ = 0;
@@ -241,8 +268,8 @@ namespace KArcCache {
             else curAverageNum_ = static_cast<int>(curTotalNum_ / static_cast<long long>(nodeMap_.size()));
         }
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::handleOverMaxAverageNum() {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::handleOverMaxAverageNum() {
             if (nodeMap_.empty()) return;
 
             // 收集所有节点
@@ -275,8 +302,8 @@ namespace KArcCache {
 
 
 
-        template<typename Key, typename Value>
-        void KLfuCache<Key, Value>::updateMinFreq() {
+        template<typename Key, typename Value, typename Hash, typename KeyEqual>
+        void KLfuCache<Key, Value, Hash, KeyEqual>::updateMinFreq() {
             int mf = INT_MAX;
             for (const auto& p : freqToFreqList_) {
                 if (p.second && !p.second->isEmpty()) {
@@ -1,12 +1,14 @@
 #pragma once
+#include <functional>
 #include <memory>
 #include <unordered_map>
-#include <mutex>
 #include <stdexcept> // For std::out_of_range
 #include "KICachePolicy.h" // 确保包含 KICachePolicy
+#include "KCacheMutex.h"
 
 namespace KArcCache {
-	template<typename Key, typename Value> class KLruCache; // 前向声明
+	// 前向声明；Hash / KeyEqual 作用于节点表，含义与 std::unordered_map 的同名参数相同
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>> class KLruCache;
 
 	template<typename Key, typename Value>
 	class LruNode {
@@ -26,20 +28,20 @@ namespace KArcCache {
 		size_t getAccessCount()const { return accessCount_; }
 		void increaseAccessCount() { ++accessCount_; }
 
-		friend class KLruCache<Key, Value>;
+		template<typename K, typename V, typename H, typename E> friend class KLruCache;
 	};
 
-	template<typename Key, typename Value>
+	template<typename Key, typename Value, typename Hash, typename KeyEqual>
 	class KLruCache :public KICachePolicy<Key, Value> { // 继承 KICachePolicy
 	public:
 		using LruNodeType = LruNode<Key, Value>;
 		using NodePtr = std::shared_ptr<LruNodeType>;
-		using NodeMap = std::unordered_map<Key, NodePtr>;
+		using NodeMap = std::unordered_map<Key, NodePtr, Hash, KeyEqual>;
 
 	private:
 		int capacity_;// 缓存容量
 		NodeMap nodeMap_;// key -> Node
-		std::mutex mutex_;
+		CacheMutex mutex_;
 		NodePtr dummyHead_;// 虚拟头节点
 		NodePtr dummyTail_;// 虚拟尾节点
 
@@ -134,7 +136,7 @@ namespace KArcCache {
 		// KICachePolicy::put (纯虚函数实现)
 		void put(Key key, Value value) override {
 			if (capacity_ <= 0) return;
-			std::lock_guard<std::mutex> lk(mutex_);
+			std::lock_guard<CacheMutex> lk(mutex_);
 			auto it = nodeMap_.find(key);
 			if (it != nodeMap_.end()) {
 				updateExistingNode(it->second, value);
@@ -145,7 +147,7 @@ namespace KArcCache {
 
 		// KICachePolicy::get (带传出参数，纯虚函数实现)
 		bool get(Key key, Value& value) override {
-			std::lock_guard<std::mutex> lk(mutex_);
+			std::lock_guard<CacheMutex> lk(mutex_);
 			auto it = nodeMap_.find(key);
 			if (it != nodeMap_.end()) {
 				moveToMostRecent(it->second);
@@ -166,31 +168,55 @@ namespace KArcCache {
 		}
 
 		void remove(Key key) {
-			std::lock_guard<std::mutex> lk(mutex_);
+			std::lock_guard<CacheMutex> lk(mutex_);
 			auto it = nodeMap_.find(key);
 			if (it != nodeMap_.end()) {
 				removeNode(it->second);
 				nodeMap_.erase(it);
 			}
 		}
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats;
+			appendLockStats(stats, "lru", mutex_);
+			return stats;
+		}
+
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			namespace est = memory_estimate;
+			std::lock_guard<CacheMutex> lk(mutex_);
+			MemoryUsage usage;
+			usage.entries = nodeMap_.size();
+			usage.index = est::hashTable(nodeMap_);
+			usage.nodes = nodeMap_.size() * (est::sharedNode<LruNodeType>() - sizeof(Value)) + 2 * est::sharedNode<LruNodeType>();
+			usage.values = nodeMap_.size() * sizeof(Value);
+			usage.exact = static_cast<bool>(valueSize);
+			if (valueSize) {
+				for (auto& kv : nodeMap_) usage.values += valueSize(kv.second->getValue());
+			}
+			return usage;
+		}
 	};
 
 	// LRU优化：Lru-k版本。
-	template<typename Key, typename Value>
-	class KLruKCache :public KLruCache<Key, Value> {
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class KLruKCache :public KLruCache<Key, Value, Hash, KeyEqual> {
 	private:
+		using Base = KLruCache<Key, Value, Hash, KeyEqual>;
+		using History = KLruCache<Key, size_t, Hash, KeyEqual>;
+
 		int k_;
 		// historyList 只需要记录 Key -> 访问次数，因此历史缓存使用 KLruCache<Key, size_t>
-		std::unique_ptr<KLruCache<Key, size_t>> historyList_;
+		std::unique_ptr<History> historyList_;
 		// historyValueMap 用于临时存储未进入主缓存的值
-		std::unordered_map<Key, Value> historyValueMap_;
+		std::unordered_map<Key, Value, Hash, KeyEqual> historyValueMap_;
 
 	public:
 		// 修正：基类构造函数调用
 		KLruKCache(int capacity, int historyCapacity, int k) :
-			// 必须使用基类的构造函数 KLruCache<Key, Value>
-			KLruCache<Key, Value>(capacity),
-			historyList_(std::make_unique < KLruCache<Key, size_t>>(historyCapacity)),
+			// 必须使用基类的构造函数 KLruCache<Key, Value, Hash, KeyEqual>
+			Base(capacity),
+			historyList_(std::make_unique<History>(historyCapacity)),
 			k_(k) {}
 
 		KLruKCache() = delete;
@@ -200,7 +226,7 @@ namespace KArcCache {
 			// 1. 查看是否存在主缓存中
 			Value value{};
 			// 调用基类的 get(key, value) 来检查和更新主缓存
-			bool isInMainCache = KLruCache<Key, Value>::get(key, value);
+			bool isInMainCache = Base::get(key, value);
 
 			// 2. 获取并更新访问历史计数
 			size_t historyCount = 0;
@@ -229,7 +255,7 @@ namespace KArcCache {
 					historyValueMap_.erase(key);
 
 					// 添加到主缓存 (调用基类 put)
-					KLruCache<Key, Value>::put(key, storedValue);
+					Base::put(key, storedValue);
 
 					return storedValue;
 				}
@@ -247,11 +273,11 @@ namespace KArcCache {
 
 			// 1. 查看是否存在缓存中，如果存在则更新并返回
 			// 调用基类的 get(key, value) 来检查和更新主缓存（将其移动到最新位置）
-			bool isInMainCache = KLruCache<Key, Value>::get(key, existingValue);
+			bool isInMainCache = Base::get(key, existingValue);
 
 			if (isInMainCache) {
 				// 存在则更新主缓存的值（基类的 put 会调用 updateExistingNode）
-				KLruCache<Key, Value>::put(key, value);
+				Base::put(key, value);
 				return;
 			}
 
@@ -275,8 +301,28 @@ namespace KArcCache {
 				// 达到阈值，晋升到主缓存
 				historyList_->remove(key);
 				historyValueMap_.erase(key);
-				KLruCache<Key, Value>::put(key, value);
+				Base::put(key, value);
+			}
+		}
+
+		std::vector<NamedLockStats> lockStats() override {
+			std::vector<NamedLockStats> stats = Base::lockStats();
+			for (auto& s : historyList_->lockStats()) {
+				stats.push_back({ "lru-k.history", s.stats });
+			}
+			return stats;
+		}
+
+		// 访问历史（historyList_ 与暂存值）全部计入 ghost
+		MemoryUsage memoryUsage(const ValueSizer<Value>& valueSize = nullptr) override {
+			namespace est = memory_estimate;
+			MemoryUsage usage = Base::memoryUsage(valueSize);
+			usage.ghost += historyList_->memoryUsage().total();
+			usage.ghost += est::hashTable(historyValueMap_);
+			if (valueSize) {
+				for (auto& kv : historyValueMap_) usage.ghost += valueSize(kv.second);
 			}
+			return usage;
 		}
 
 		// KICachePolicy::get (带传出参数) - 必须实现
@@ -284,7 +330,7 @@ namespace KArcCache {
 			// 对于 LRU-K，我们只需要调用基类的 get 来检查主缓存
 			// 历史记录更新应该在 Value get(Key key) 中集中处理，以避免重复逻辑
 			// 但为了满足 KICachePolicy 接口，这里只实现主缓存的查找和更新
-			return KLruCache<Key, Value>::get(key, value);
+			return Base::get(key, value);
 		}
 	};
 }
@@ -4,4 +4,11 @@ void printResults(const std::string& name, int capacity, int get_ops, int hits)
         << " | gets=" << get_ops
         << " | hits=" << hits
         << " | hit_rate=" << (get_ops ? (hits * 100.0 / get_ops) : 0) << "%\n";
-}
\ No newline at end of file
+}
+void printResults(const std::string& name, int capacity, int get_ops, int hits, double elapsed_ms) {
+    std::cout << name << " | cap=" << capacity
+        << " | gets=" << get_ops
+        << " | hits=" << hits
+        << " | hit_rate=" << (get_ops ? (hits * 100.0 / get_ops) : 0) << "%"
+        << " | time=" << elapsed_ms << "ms\n";
+}
@@ -1,4 +1,6 @@
 #pragma once
 #include <string>
 #include <iostream>
-void printResults(const std::string& name, int capacity, int get_ops, int hits);
\ No newline at end of file
+void printResults(const std::string& name, int capacity, int get_ops, int hits);
+// 附带计时：elapsed_ms 只包含缓存操作本身，不含负载生成
+void printResults(const std::string& name, int capacity, int get_ops, int hits, double elapsed_ms);
@@ -1,6 +1,19 @@
 #include "testHotDataAccess.h"
 #include "testLoopPattern.h"
 #include "testWorkloadShift.h"
+#include "testParallelSweep.h"
+#include "testMemoryOverhead.h"
+#include "testConcurrentThroughput.h"
+#include "testTraceReplay.h"
+#include "testCostAware.h"
+#include "testPutLatency.h"
+#include "testWarmRestart.h"
+#include "testSharedMemory.h"
+#include "testAccessRecording.h"
+#include "testHotKeys.h"
+#include "testCompactArc.h"
+#include "testArcCorrectness.h"
+#include "testStringKeys.h"
 int main() {
 	tetestHotDataAccess a;
 	a();
@@ -8,4 +21,30 @@ int main() {
 	b();
 	testWorkloadShift c;
 	c();
+	testParallelSweep d;
+	d();
+	testMemoryOverhead e;
+	e();
+	testConcurrentThroughput f;
+	f();
+	testTraceReplay g;
+	g();
+	testCostAware h;
+	h();
+	testPutLatency i;
+	i();
+	testWarmRestart j;
+	j();
+	testSharedMemory k;
+	k();
+	testAccessRecording l;
+	l();
+	testHotKeys m;
+	m();
+	testCompactArc n;
+	n();
+	testArcCorrectness o;
+	o();
+	testStringKeys p;
+	p();
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "testAccessRecording.h"
+#include "KArcCache.h"
+#include "KAccessRecorder.h"
+#include "KTraceReader.h"
+#include "KWorkload.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    struct LiveRun {
+        std::unique_ptr<KArcCache::ArcCache<int, std::string>> cache;
+        std::unique_ptr<KArcCache::AccessRecorder> recorder;
+        double ms = 0;
+        std::vector<double> blockMs;
+        size_t gets = 0;
+        size_t hits = 0;
+    };
+
+    // 旁路缓存回放 ops[begin, end)，耗时累加到 run.ms
+    void runBlock(LiveRun& run, const KArcCache::workload::Ops<int>& ops, size_t begin, size_t end,
+        const std::vector<std::string>& values) {
+        auto start = std::chrono::steady_clock::now();
+        std::string value;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& op = ops[i];
+            if (op.type == KArcCache::TraceOpType::Put) {
+                run.cache->put(op.key, values[op.key]);
+                continue;
+            }
+            ++run.gets;
+            if (run.cache->get(op.key, value)) ++run.hits;
+            else run.cache->put(op.key, values[op.key]);
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        run.ms += ms;
+        run.blockMs.push_back(ms);
+    }
+
+    // 开销取各块耗时比值的中位数，个别被打断的块不影响结果
+    double medianOverhead(const LiveRun& run, const LiveRun& base) {
+        std::vector<double> ratios;
+        for (size_t i = 0; i < run.blockMs.size(); ++i) ratios.push_back(run.blockMs[i] / base.blockMs[i] - 1.0);
+        std::sort(ratios.begin(), ratios.end());
+        return ratios.empty() ? 0.0 : ratios[ratios.size() / 2] * 100.0;
+    }
+
+    long long fileSize(const std::string& path) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        return in ? static_cast<long long>(in.tellg()) : 0;
+    }
+
+    // 录下的 trace 回放进容量为 capacity 的新 ARC
+    double replayRecorded(const std::string& path, size_t capacity) {
+        std::ifstream in(path, std::ios::binary);
+        KArcCache::RecordedTraceReader reader(in);
+        if (!reader.ok()) return 0.0;
+        KArcCache::ArcCache<uint64_t, int> cache(capacity, 2);
+        return KArcCache::replayTrace(reader, cache, 0).hitRate();
+    }
+}
+
+void testAccessRecording::operator()() {
+    std::cout << "\n=== Test scenario 12: live access recording ===" << std::endl;
+
+    const int CAPACITY = 10000;
+    const int KEYS = 100000;
+    const int OPERATIONS = 1000000;
+    const int BLOCK = 50000;
+    const double SAMPLE_RATE = 0.1;
+    const std::vector<std::string> names = { "ARC", "ARC+rec(100%)", "ARC+rec(10%)" };
+    const std::vector<std::string> paths = { "", "arc-trace-full.bin", "arc-trace-sampled.bin" };
+    const std::vector<double> rates = { 0.0, 1.0, SAMPLE_RATE };
+
+    const auto ops = KArcCache::workload::scrambledZipfian(OPERATIONS, KEYS, 0.9, 5, 121);
+    const auto values = KArcCache::workload::makeValues(KEYS, "value");
+
+    std::vector<LiveRun> runs(names.size());
+    for (size_t c = 0; c < runs.size(); ++c) {
+        runs[c].cache = std::make_unique<KArcCache::ArcCache<int, std::string>>(CAPACITY, 2);
+        if (paths[c].empty()) continue;
+        runs[c].recorder = std::make_unique<KArcCache::AccessRecorder>(paths[c], rates[c]);
+        runs[c].cache->setRecorder(runs[c].recorder.get(), [](const std::string& v) { return v.size(); });
+    }
+
+    // 三个缓存按块轮流处理同一串请求，每块换一次先后顺序：整段连续跑时堆状态与机器抖动带来的差异
+    // 比录制本身的开销还大，交错后各配置受到的影响相同
+    for (size_t begin = 0, block = 0; begin < ops.size(); begin += BLOCK, ++block) {
+        size_t end = std::min(ops.size(), begin + static_cast<size_t>(BLOCK));
+        for (size_t k = 0; k < runs.size(); ++k) runBlock(runs[(block + k) % runs.size()], ops, begin, end, values);
+    }
+
+    for (size_t c = 0; c < runs.size(); ++c) {
+        LiveRun& run = runs[c];
+        uint64_t written = 0, dropped = 0;
+        if (run.recorder) {
+            auto start = std::chrono::steady_clock::now();
+            run.recorder->flush(); // 收尾写入计入该配置的总耗时
+            run.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            written = run.recorder->written();
+            dropped = run.recorder->dropped();
+            run.recorder.reset();
+        }
+        std::cout << names[c] << " | hit_rate=" << (run.gets ? run.hits * 100.0 / run.gets : 0.0)
+            << "% | Mops/s=" << OPERATIONS / run.ms / 1000.0
+            << " | overhead=" << medianOverhead(run, runs[0]) << "%";
+        if (!paths[c].empty()) {
+            std::cout << " | records=" << written << " | dropped=" << dropped << " | bytes=" << fileSize(paths[c]);
+        }
+        std::cout << "\n";
+    }
+
+    // 全量 trace 按原容量回放应与在线命中率一致；10% 采样的 trace 按 SHARDS 方式在 1/10 容量上回放做估计
+    std::cout << "replay full trace | capacity=" << CAPACITY << " | hit_rate=" << replayRecorded(paths[1], CAPACITY) << "%\n";
+    size_t scaled = static_cast<size_t>(CAPACITY * SAMPLE_RATE);
+    std::cout << "replay 10% trace | capacity=" << scaled << " | hit_rate=" << replayRecorded(paths[2], scaled) << "%\n";
+    std::remove(paths[1].c_str());
+    std::remove(paths[2].c_str());
+}
@@ -0,0 +1,164 @@
+#include "testArcCorrectness.h"
+#include "KArcCache.h"
+#include "KCompactArcCache.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    void report(const std::string& name, bool ok, const std::string& detail) {
+        std::cout << name << " | ok=" << ok << " | " << detail << "\n";
+    }
+
+    // 偏斜预热（80 个键，前 8 个占 70% 的请求，三分之一写入，夹杂删除）会让 LFU 幽灵反复命中，把 LRU 部分的容量压到 0。
+    // 之后写入再立刻读回的键必须命中，两个新键交替写读也必须命中
+    template<typename Cache>
+    void checkPutThenGet(const std::string& name, size_t capacity) {
+        Cache cache(capacity, 2);
+        std::mt19937 rng(27);
+        int value;
+        auto skewedKey = [&] { return static_cast<int>(rng() % 10 < 7 ? rng() % 8 : rng() % 80); };
+        for (int i = 0; i < 200000; ++i) {
+            int key = skewedKey();
+            if (rng() % 3 == 0) cache.put(key, key);
+            else if (!cache.get(key, value)) cache.put(key, key);
+            if (rng() % 10 == 0) cache.erase(static_cast<int>(rng() % 80));
+        }
+
+        size_t pairs = 0, misses = 0;
+        for (int i = 0; i < 100000; ++i) {
+            int key = skewedKey();
+            if (rng() % 3 == 0) {
+                cache.put(key, key);
+                ++pairs;
+                if (!cache.get(key, value) || value != key) ++misses;
+            }
+            else if (!cache.get(key, value)) cache.put(key, key);
+        }
+        size_t loopHits = 0;
+        for (int i = 0; i < 1000; ++i) {
+            int key = 1000 + (i & 1);
+            cache.put(key, key);
+            if (cache.get(key, value)) ++loopHits;
+        }
+        report(name + " put-then-get after skew, capacity=" + std::to_string(capacity), misses == 0 && loopHits == 1000,
+            "missed " + std::to_string(misses) + "/" + std::to_string(pairs)
+            + " | two-key loop hits " + std::to_string(loopHits) + "/1000");
+    }
+
+    // 三个线程持续读写（30% 写入）时反复缩容、扩容。缩容只改上限，超出的条目由之后的读写分批回收，
+    // 所以每次调整后等负载线程再跑 20000 次操作，再检查 size() <= 容量；最后确认缩到很小之后新键仍能写入并读回
+    void checkResizeUnderLoad() {
+        KArcCache::ArcCache<int, int> cache(4000, 2);
+        std::atomic<bool> stop{ false }, paused{ false };
+        std::atomic<size_t> ops{ 0 };
+        std::atomic<int> parked{ 0 };
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 3; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937 rng(290 + t);
+                int value;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    if (paused.load()) {
+                        ++parked;
+                        while (paused.load()) std::this_thread::yield();
+                        --parked;
+                    }
+                    int key = static_cast<int>(rng() % 10 < 7 ? rng() % 2000 : rng() % 20000);
+                    if (rng() % 10 < 3) cache.put(key, key);
+                    else if (!cache.get(key, value)) cache.put(key, key);
+                    ops.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        size_t checks = 0, violations = 0, worstExcess = 0;
+        for (size_t capacity : { 500, 8000, 50, 1, 3000, 20, 4000 }) {
+            cache.setCapacity(capacity);
+            size_t target = ops.load() + 20000;
+            while (ops.load() < target) std::this_thread::yield();
+            // size() 分两次读两部分，晋升途中的节点可能被数两次：读之前让负载停在操作之间
+            paused = true;
+            while (parked.load() < 3) std::this_thread::yield();
+            size_t size = cache.size();
+            paused = false;
+            ++checks;
+            if (size > capacity) {
+                ++violations;
+                worstExcess = std::max(worstExcess, size - capacity);
+            }
+        }
+        stop = true;
+        for (auto& w : workers) w.join();
+
+        cache.setCapacity(2);
+        int value = 0;
+        for (int i = 0; i < 1000 && cache.size() > 2; ++i) cache.get(-1, value); // 每次操作最多回收 8 个，让缩容追上
+        cache.put(-2, 42);
+        bool accepts = cache.get(-2, value) && value == 42;
+        report("resize under load", violations == 0 && accepts && cache.size() <= 2,
+            "size <= capacity in " + std::to_string(checks - violations) + "/" + std::to_string(checks)
+            + " checks (worst excess " + std::to_string(worstExcess) + ") | put-then-get at capacity 2: " + (accepts ? "hit" : "miss"));
+    }
+
+    // 三个线程用 0..9999 号键（标签 1..64）持续读写，主线程同时失效其中的标签，并对专用的键反复验证：
+    // erase 之后、所在标签失效之后，get 都必须未命中。负载停下后，新键仍要能写入并读回
+    void checkEraseAndInvalidate() {
+        KArcCache::ArcCache<int, int> cache(2000, 2);
+        std::atomic<bool> stop{ false };
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 3; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937 rng(310 + t);
+                int value;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    int key = static_cast<int>(rng() % 10 < 7 ? rng() % 500 : rng() % 10000);
+                    uint64_t tag = static_cast<uint64_t>(key % 64) + 1;
+                    if (rng() % 10 < 3 || !cache.get(key, value)) cache.put(key, key, tag);
+                    if (rng() % 50 == 0) cache.erase(static_cast<int>(rng() % 10000));
+                }
+            });
+        }
+
+        size_t rounds = 20000, stale = 0;
+        int value;
+        for (size_t i = 0; i < rounds; ++i) {
+            int erased = 100000 + static_cast<int>(i);
+            cache.put(erased, 1);
+            cache.erase(erased);
+            if (cache.get(erased, value)) ++stale;
+
+            int tagged = 200000 + static_cast<int>(i);
+            uint64_t tag = 1000 + i;
+            cache.put(tagged, 1, tag);
+            cache.invalidateTag(tag);
+            if (cache.get(tagged, value)) ++stale;
+
+            if (i % 100 == 0) cache.invalidateTag(i / 100 % 64 + 1); // 同时批量失效负载线程的标签
+        }
+        stop = true;
+        for (auto& w : workers) w.join();
+
+        size_t accepted = 0;
+        for (int i = 0; i < 1000; ++i) {
+            cache.put(300000 + i, i);
+            if (cache.get(300000 + i, value) && value == i) ++accepted;
+        }
+        report("erase and invalidate under load", stale == 0 && accepted == 1000 && cache.size() > 0,
+            "stale hits " + std::to_string(stale) + "/" + std::to_string(rounds * 2)
+            + " | new keys accepted " + std::to_string(accepted) + "/1000 | size " + std::to_string(cache.size()));
+    }
+}
+
+void testArcCorrectness::operator()() {
+    std::cout << "\n=== Test scenario 15: ArcCache correctness checks ===" << std::endl;
+
+    for (size_t capacity : { 3, 7, 20 }) checkPutThenGet<KArcCache::ArcCache<int, int>>("ArcCache", capacity);
+    for (size_t capacity : { 3, 7, 20 }) checkPutThenGet<KArcCache::CompactArcCache<int, int>>("CompactArcCache", capacity);
+    checkResizeUnderLoad();
+    checkEraseAndInvalidate();
+}
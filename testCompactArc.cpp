@@ -0,0 +1,66 @@
+#include "testCompactArc.h"
+#include "KArcCache.h"
+#include "KCompactArcCache.h"
+#include "KWorkload.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace {
+    // 旁路缓存回放（未命中时回填）：先用 warmup 个请求预热，再对其余请求计时并统计命中率
+    template<typename Cache>
+    void run(const std::string& name, Cache& cache, const KArcCache::workload::Ops<int>& ops, size_t warmup) {
+        size_t gets = 0, hits = 0;
+        long value;
+        auto replay = [&](size_t from, size_t to, bool count) {
+            for (size_t i = from; i < to; ++i) {
+                const auto& op = ops[i];
+                if (op.type == KArcCache::TraceOpType::Put) {
+                    cache.put(op.key, op.key);
+                    continue;
+                }
+                bool hit = cache.get(op.key, value);
+                if (!hit) cache.put(op.key, op.key);
+                if (count) {
+                    ++gets;
+                    if (hit) ++hits;
+                }
+            }
+        };
+        replay(0, warmup, false);
+        auto start = std::chrono::steady_clock::now();
+        replay(warmup, ops.size(), true);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        KArcCache::MemoryUsage usage = cache.memoryUsage();
+        double perEntry = usage.entries ? 1.0 / usage.entries : 0.0;
+        std::cout << name << " | hit_rate=" << (gets ? hits * 100.0 / gets : 0.0)
+            << "% | Mops/s=" << (ops.size() - warmup) / ms / 1000.0
+            << " | entries=" << usage.entries
+            << " | bytes/entry=" << usage.total() * perEntry
+            << " (index=" << usage.index * perEntry
+            << ", nodes=" << usage.nodes * perEntry
+            << ", ghost=" << usage.ghost * perEntry
+            << ", freq=" << usage.freqBuckets * perEntry << ")\n";
+    }
+}
+
+void testCompactArc::operator()() {
+    std::cout << "\n=== Test scenario 14: compact ARC for small trivially-copyable keys/values ===" << std::endl;
+
+    const int OPERATIONS = 600000;
+
+    // 小容量时热数据基本都在 CPU 缓存里，主要比较常数开销；大容量时节点散落在堆上，比较访存局部性
+    for (int capacity : { 1000, 20000 }) {
+        const int keys = capacity * 10;
+        const auto ops = KArcCache::workload::scrambledZipfian(OPERATIONS, keys, 0.9, 5, 141);
+        std::cout << "capacity=" << capacity << " | keys=" << keys << "\n";
+
+        KArcCache::ArcCache<int, long> generic(capacity, 2);
+        run("ArcCache<int, long>", generic, ops, OPERATIONS / 3);
+
+        // int / long 满足条件，ArcCacheFor 选中 CompactArcCache
+        KArcCache::ArcCacheFor<int, long> compact(capacity, 2);
+        run("ArcCacheFor<int, long> (compact)", compact, ops, OPERATIONS / 3);
+    }
+}
@@ -0,0 +1,111 @@
+#include "testConcurrentThroughput.h"
+#include "KArcCache.h"
+#include "KArcFrontCache.h"
+#include "KS3FifoCache.h"
+#include "KArcWriteBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // 每个线程回放自己预先生成的键序列，统计总吞吐与命中率
+    void runThreads(const std::string& name, KArcCache::KICachePolicy<int, std::string>& cache,
+        const std::vector<std::vector<int>>& keys, int putPercent) {
+        std::atomic<long long> hits{ 0 };
+        std::atomic<long long> gets{ 0 };
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < keys.size(); ++t) {
+            threads.emplace_back([&, t] {
+                long long localHits = 0, localGets = 0;
+                std::string value;
+                for (size_t i = 0; i < keys[t].size(); ++i) {
+                    int key = keys[t][i];
+                    if (int(i % 100) < putPercent) {
+                        cache.put(key, "value");
+                    }
+                    else {
+                        ++localGets;
+                        if (cache.get(key, value)) ++localHits;
+                    }
+                }
+                hits += localHits;
+                gets += localGets;
+            });
+        }
+        for (auto& th : threads) th.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t ops = 0;
+        for (const auto& k : keys) ops += k.size();
+        std::cout << name << " | threads=" << keys.size()
+            << " | Mops/s=" << ops / seconds / 1e6
+            << " | hit_rate=" << (gets ? hits * 100.0 / gets : 0) << "%\n";
+    }
+
+    // 以 -DKARC_LOCK_STATS 编译时打印各把锁的竞争情况
+    void printLockStats(KArcCache::KICachePolicy<int, std::string>& cache) {
+        for (const auto& lock : cache.lockStats()) {
+            const auto& s = lock.stats;
+            std::cout << "  lock " << lock.name << " | acquisitions=" << s.acquisitions
+                << " | shared=" << s.sharedAcquisitions
+                << " | contended=" << s.contended
+                << " | avg_wait_ns=" << (s.contended ? s.waitNs / s.contended : 0)
+                << " | avg_hold_ns=" << (s.acquisitions ? s.holdNs / s.acquisitions : 0) << "\n";
+        }
+    }
+}
+
+void testConcurrentThroughput::operator()() {
+    std::cout << "\n=== Test scenario 6: multithreaded throughput (hot keys) ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int OPS_PER_THREAD = 500000;
+    const int HOT_KEYS = 20;
+    const int COLD_KEYS = 5000;
+    const int PUT_PERCENT = 2;
+    const int THREADS = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+
+    // 90% 的读落在 20 个热点键上
+    std::vector<std::vector<int>> keys(THREADS);
+    for (int t = 0; t < THREADS; ++t) {
+        std::mt19937 gen(1000 + t);
+        keys[t].reserve(OPS_PER_THREAD);
+        for (int i = 0; i < OPS_PER_THREAD; ++i) {
+            keys[t].push_back(gen() % 100 < 90 ? int(gen() % HOT_KEYS) : HOT_KEYS + int(gen() % COLD_KEYS));
+        }
+    }
+
+    KArcCache::ArcCache<int, std::string> arc(CAPACITY, 2);
+    runThreads("ARC", arc, keys, PUT_PERCENT);
+    printLockStats(arc);
+
+    // 读缓冲：命中只加共享锁，链表/频次桶的更新攒批回放
+    KArcCache::ArcCache<int, std::string> readBuffered(CAPACITY, 2);
+    readBuffered.enableReadBuffers();
+    runThreads("ARC+RB", readBuffered, keys, PUT_PERCENT);
+    printLockStats(readBuffered);
+    std::cout << "  dropped_reads=" << readBuffered.droppedReads() << "\n";
+
+    KArcCache::ArcCache<int, std::string> shared(CAPACITY, 2);
+    KArcCache::ArcFrontCache<int, std::string> front(shared);
+    runThreads("ARC+L1", front, keys, PUT_PERCENT);
+
+    // 命中只加共享锁并原子地更新频次
+    KArcCache::KS3FifoCache<int, std::string> s3fifo(CAPACITY);
+    runThreads("S3-FIFO", s3fifo, keys, PUT_PERCENT);
+
+    // 写多的负载：30% 写入，热点键被反复覆盖；写缓冲把同键写入合并后成批交给 ArcCache
+    const int WRITE_HEAVY_PERCENT = 30;
+    KArcCache::ArcCache<int, std::string> direct(CAPACITY, 2);
+    runThreads("ARC (30% put)", direct, keys, WRITE_HEAVY_PERCENT);
+    KArcCache::ArcCache<int, std::string> buffered(CAPACITY, 2);
+    {
+        KArcCache::ArcWriteBuffer<int, std::string> writeBuffer(buffered);
+        runThreads("ARC+WB (30% put)", writeBuffer, keys, WRITE_HEAVY_PERCENT);
+    }
+}
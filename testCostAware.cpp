@@ -0,0 +1,71 @@
+#include "testCostAware.h"
+#include "KArcCache.h"
+#include "KGdsfCache.h"
+#include "KLirsCache.h"
+#include "KWorkload.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "LRU_K.h"
+#include "LFU.h"
+void testCostAware::operator()() {
+    std::cout << "\n=== Test scenario 8: cost- and size-aware caching ===" << std::endl;
+
+    const int KEYS = 5000;
+    const int OPERATIONS = 300000;
+    const double MIN_SIZE = 100, MAX_SIZE = 1000000; // 大小相差 10^4 倍
+    const double MIN_COST = 1, MAX_COST = 500;       // 回源代价 1ms ~ 500ms
+
+    // 每个键的大小与回源代价都按对数均匀分布，且相互独立
+    KArcCache::workload::Rng rng(37);
+    std::vector<size_t> sizes(KEYS);
+    std::vector<double> costs(KEYS);
+    double totalBytes = 0;
+    for (int k = 0; k < KEYS; ++k) {
+        sizes[k] = size_t(MIN_SIZE * std::pow(MAX_SIZE / MIN_SIZE, rng.uniform()));
+        costs[k] = MIN_COST * std::pow(MAX_COST / MIN_COST, rng.uniform());
+        totalBytes += double(sizes[k]);
+    }
+    const auto ops = KArcCache::workload::scrambledZipfian(OPERATIONS, KEYS, 0.9, 0, 38);
+
+    // 同样的内存预算：GDSF 按字节计；其余策略按条目数计，取预算 / 平均大小
+    const size_t CAPACITY_BYTES = size_t(totalBytes * 0.05);
+    const int CAPACITY_ENTRIES = int(CAPACITY_BYTES / (totalBytes / KEYS));
+
+    KArcCache::KLruCache<int, int> lru(CAPACITY_ENTRIES);
+    KArcCache::KLfuCache<int, int> lfu(CAPACITY_ENTRIES, 10);
+    KArcCache::ArcCache<int, int> arc(CAPACITY_ENTRIES, 2);
+    KArcCache::KLirsCache<int, int> lirs(CAPACITY_ENTRIES);
+    KArcCache::KGdsfCache<int, int> gdsf(CAPACITY_BYTES);
+
+    std::vector<KArcCache::KICachePolicy<int, int>*> caches = { &lru, &lfu, &arc, &lirs, &gdsf };
+    std::vector<std::string> names = { "LRU", "LFU", "ARC", "LIRS", "GDSF" };
+
+    for (size_t i = 0; i < caches.size(); ++i) {
+        long long hits = 0;
+        double hitBytes = 0, allBytes = 0, savedCost = 0, allCost = 0;
+        int value = 0;
+        // 每次都是读，未命中则按需回填
+        for (const auto& op : ops) {
+            int key = op.key;
+            allBytes += double(sizes[key]);
+            allCost += costs[key];
+            if (caches[i]->get(key, value)) {
+                ++hits;
+                hitBytes += double(sizes[key]);
+                savedCost += costs[key];
+            }
+            else if (caches[i] == &gdsf) {
+                gdsf.put(key, key, costs[key], sizes[key]);
+            }
+            else {
+                caches[i]->put(key, key);
+            }
+        }
+        std::cout << names[i] << " | budget=" << CAPACITY_BYTES << "B"
+            << " | hit_rate=" << hits * 100.0 / ops.size() << "%"
+            << " | byte_hit_rate=" << hitBytes * 100.0 / allBytes << "%"
+            << " | miss_cost_saved=" << savedCost * 100.0 / allCost << "%\n";
+    }
+}
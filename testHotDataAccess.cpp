@@ -1,5 +1,12 @@
 #include "testHotDataAccess.h"
 #include "printResults.h"
+#include "KLirsCache.h"
+#include "KSlruCache.h"
+#include "K2QCache.h"
+#include "KMetaCache.h"
+#include "KWorkload.h"
+#include <chrono>
+#include <cmath>
 
 
 void tetestHotDataAccess::operator()() {
@@ -13,15 +20,54 @@ void tetestHotDataAccess::operator()() {
     KArcCache::KLruKCache<int, std::string> lru(CAPACITY, 10, 2);
     KArcCache::KLfuCache<int, std::string> lfu(CAPACITY, 10);
     KArcCache::ArcCache<int, std::string> arc(CAPACITY, TRANSFORM_THRESHOLD);
+    // 曲线只到 80 的容量，估计器会把采样率提到 1（见 ArcMrcEstimator 的采样率下限）
+    arc.enableMissRatioCurve(0.1, CAPACITY * 4);
+    // Let shadow caches pick transformThreshold and the initial LRU/LFU split
+    arc.enableAutoTuning();
+    KArcCache::KLirsCache<int, std::string> lirs(CAPACITY);
+    KArcCache::KSlruCache<int, std::string> slru(CAPACITY);
+    KArcCache::K2QCache<int, std::string> twoQ(CAPACITY);
+    // 在 LRU / LFU / ARC 之间按影子命中率切换
+    // 候选与上面单独测的三种策略参数一致：LRU-K、LFU、开启自动调参的 ARC
+    using Meta = KArcCache::KMetaCache<int, std::string>;
+    std::vector<Meta::Candidate> candidates = {
+        { "LRU-K", [](size_t cap) { return std::unique_ptr<Meta::Policy>(new KArcCache::KLruKCache<int, std::string>(int(cap), 10, 2)); } },
+        { "LFU", [](size_t cap) { return std::unique_ptr<Meta::Policy>(new KArcCache::KLfuCache<int, std::string>(int(cap), 10)); } },
+        { "ARC", [](size_t cap) {
+            auto arc = new KArcCache::ArcCache<int, std::string>(cap, TRANSFORM_THRESHOLD);
+            arc->enableAutoTuning();
+            return std::unique_ptr<Meta::Policy>(arc); } },
+    };
+    Meta meta(CAPACITY, candidates);
 
-    // generate random data
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // 固定种子，每次运行回放同一序列，结果可复现
+    KArcCache::workload::Rng rng(1001);
 
-    std::array<KArcCache::KICachePolicy<int, std::string>*, 3> caches = { &lru, &lfu, &arc };
-    std::vector<int> hits(3, 0); // Record the number of cache hits for each of the three strategies
-    std::vector<int> get_operations(3, 0); // The total number of cache accesses for each of the three strategy tests
-    std::vector<std::string> names = { "LRU", "LFU", "ARC" };
+    // 先生成完整的操作序列与写入的值，所有策略回放同一序列，计时只覆盖缓存操作
+    KArcCache::workload::Ops<int> ops;
+    std::vector<std::string> putValues;
+    ops.reserve(OPERATIONS);
+    for (int op = 0; op < OPERATIONS; op++) {
+        // In most cache systems, read operations are more frequent than write operations.
+        // Therefore, set a 30% probability for write operations.
+        bool isPut = rng.percent(30);
+        int key;
+
+        // 70% probability of accessing hot data, 30% probability of accessing cold data
+        if (rng.percent(70)) {
+            key = int(rng.below(HOT_KEYS)); // hot data
+        }
+        else {
+            key = HOT_KEYS + int(rng.below(COLD_KEYS)); // cold data
+        }
+        if (isPut) putValues.push_back("value" + std::to_string(key) + "_v" + std::to_string(op % 100));
+        ops.push_back(KArcCache::workload::makeOp<int>(key, isPut));
+    }
+
+    std::vector<KArcCache::KICachePolicy<int, std::string>*> caches = { &lru, &lfu, &arc, &lirs, &slru, &twoQ, &meta };
+    std::vector<int> hits(caches.size(), 0); // Record the number of cache hits for each strategy
+    std::vector<int> get_operations(caches.size(), 0); // The total number of cache accesses for each strategy
+    std::vector<std::string> names = { "LRU", "LFU", "ARC", "LIRS", "SLRU", "2Q", "Meta" };
 
     // Perform the same sequence of operations on all cached objects
     for (int i = 0; i < caches.size(); i++) {
@@ -32,34 +78,46 @@ void tetestHotDataAccess::operator()() {
         }
 
         // Alternate put and get operations to simulate real scenarios
-        for (int op = 0; op < OPERATIONS; op++) {
-            // In most cache systems, read operations are more frequent than write operations.
-            // Therefore, set a 30% probability for write operations.
-            bool isPut = (gen() % 100 < 30);
-            int key;
-
-            // 70% probability of accessing hot data, 30% probability of accessing cold data
-            if (gen() % 100 < 70) {
-                key = gen() % HOT_KEYS; // hot data
-            }
-            else {
-                key = HOT_KEYS + (gen() % COLD_KEYS); // cold data
-            }
-
-            if (isPut) {
-                std::string value = "value" + std::to_string(key) + "_v" + std::to_string(op % 100);
-                caches[i]->put(key, value);
+        size_t nextValue = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (const auto& op : ops) {
+            if (op.type == KArcCache::TraceOpType::Put) {
+                caches[i]->put(op.key, putValues[nextValue++]);
             }
             else {
                 // Execute the get operation and record the hit situation
                 std::string result;
                 get_operations[i]++;
-                if (caches[i]->get(key, result)) {
+                if (caches[i]->get(op.key, result)) {
                     hits[i]++;
                 }
             }
         }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
         // 打印测试结果
-        printResults("Hotspot data access test", CAPACITY, get_operations[i], hits[i]);
+        printResults(names[i], CAPACITY, get_operations[i], hits[i], elapsed);
+    }
+    std::cout << "Meta ended on " << meta.activePolicy() << " after " << meta.switches() << " switches\n";
+
+    // ARC 在线估计的 LRU 命中率，与同一序列回放进真实 LRU 的结果对照，相差超过 MRC_TOLERANCE 个百分点即 ok=0
+    const double MRC_TOLERANCE = 2.0;
+    for (int cap : { CAPACITY, CAPACITY * 3 / 2, CAPACITY * 2, CAPACITY * 3, CAPACITY * 4 }) {
+        KArcCache::KLruCache<int, std::string> exact(cap);
+        for (int key = 0; key < HOT_KEYS; key++) exact.put(key, "value" + std::to_string(key));
+        int exactGets = 0, exactHits = 0;
+        size_t nextValue = 0;
+        std::string result;
+        for (const auto& op : ops) {
+            if (op.type == KArcCache::TraceOpType::Put) {
+                exact.put(op.key, putValues[nextValue++]);
+                continue;
+            }
+            ++exactGets;
+            if (exact.get(op.key, result)) ++exactHits;
+        }
+        double estimated = arc.estimateHitRatio(cap) * 100.0;
+        double actual = exactHits * 100.0 / exactGets;
+        std::cout << "ARC estimated LRU hit_rate at cap=" << cap << ": " << estimated
+            << "% | exact LRU: " << actual << "% | ok=" << (std::abs(estimated - actual) <= MRC_TOLERANCE) << "\n";
     }
 }
@@ -0,0 +1,92 @@
+#include "testHotKeys.h"
+#include "KArcCache.h"
+#include "KShardedArcCache.h"
+#include "KWorkload.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // 各线程轮流取请求做旁路缓存（未命中时回填），返回耗时毫秒
+    double runThreads(const std::string& name, KArcCache::KICachePolicy<int, long>& cache, int threads,
+        const KArcCache::workload::Ops<int>& ops) {
+        std::atomic<size_t> gets{ 0 }, hits{ 0 };
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                size_t localGets = 0, localHits = 0;
+                long value;
+                for (size_t i = t; i < ops.size(); i += threads) {
+                    const auto& op = ops[i];
+                    if (op.type == KArcCache::TraceOpType::Put) {
+                        cache.put(op.key, op.key);
+                        continue;
+                    }
+                    ++localGets;
+                    if (cache.get(op.key, value)) ++localHits;
+                    else cache.put(op.key, op.key);
+                }
+                gets += localGets;
+                hits += localHits;
+            });
+        }
+        for (auto& w : workers) w.join();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << " | threads=" << threads << " | hit_rate=" << (gets ? hits * 100.0 / gets : 0.0)
+            << "% | Mops/s=" << ops.size() / ms / 1000.0;
+        return ms;
+    }
+
+    // 最忙分片收到的请求占全部请求的比例，以及相对均匀分布（1/分片数）的倍数
+    void printShardSkew(const KArcCache::ShardedArcCache<int, long>& cache, size_t ops) {
+        auto loads = cache.shardLoads();
+        uint64_t total = std::accumulate(loads.begin(), loads.end(), uint64_t(0));
+        uint64_t busiest = *std::max_element(loads.begin(), loads.end());
+        std::cout << " | shard_requests=" << total * 100.0 / ops << "% of ops"
+            << " | busiest_shard=" << busiest * 100.0 / ops << "% of ops ("
+            << busiest * double(loads.size()) / std::max<uint64_t>(total, 1) << "x mean)";
+    }
+}
+
+void testHotKeys::operator()() {
+    std::cout << "\n=== Test scenario 13: hot-key replication across shards ===" << std::endl;
+
+    const int THREADS = 8;
+    const int CAPACITY = 16384;
+    const int SHARDS = 16;
+    const int KEYS = 200000;
+    const int OPERATIONS = 2000000;
+    const int VIRAL_KEY = KEYS;       // 不在 Zipf 键空间里的爆款键
+    const int VIRAL_PERCENT = 25;     // 读请求中落在爆款键上的比例
+    const int VIRAL_PUT_EVERY = 2000; // 爆款键也会被改写，检验热键表的失效
+
+    auto ops = KArcCache::workload::scrambledZipfian(OPERATIONS, KEYS, 0.9, 2, 131);
+    KArcCache::workload::Rng rng(137);
+    for (size_t i = 0; i < ops.size(); ++i) {
+        if (i % VIRAL_PUT_EVERY == 0) ops[i] = KArcCache::workload::makeOp<int>(VIRAL_KEY, true);
+        else if (ops[i].type == KArcCache::TraceOpType::Get && rng.percent(VIRAL_PERCENT)) ops[i].key = VIRAL_KEY;
+    }
+
+    KArcCache::ArcCache<int, long> single(CAPACITY, 2);
+    runThreads("ARC", single, THREADS, ops);
+    std::cout << "\n";
+
+    KArcCache::ShardedArcCache<int, long> sharded(CAPACITY, SHARDS);
+    runThreads("Sharded ARC", sharded, THREADS, ops);
+    printShardSkew(sharded, ops.size());
+    std::cout << "\n";
+
+    KArcCache::ShardedArcCache<int, long> replicated(CAPACITY, SHARDS);
+    replicated.enableHotKeys();
+    runThreads("Sharded ARC+hot keys", replicated, THREADS, ops);
+    printShardSkew(replicated, ops.size());
+    auto hot = replicated.hotKeys();
+    bool viralDetected = std::find(hot.begin(), hot.end(), VIRAL_KEY) != hot.end();
+    std::cout << "\n  hot_keys=" << hot.size() << " | viral_key_detected=" << (viralDetected ? "yes" : "no") << "\n";
+}
@@ -0,0 +1,4 @@
+#pragma once
+struct testHotKeys {
+	void operator()();
+};
@@ -3,10 +3,16 @@
 #include "KArcCache.h"
 #include <iostream>
 #include <string>
-#include <array>
-#include <random>
+#include <vector>
+#include <chrono>
 #include "LRU_K.h"
 #include "LFU.h"
+#include "KWorkload.h"
+#include "KLirsCache.h"
+#include "KS3FifoCache.h"
+#include "KSlruCache.h"
+#include "K2QCache.h"
+#include "KMetaCache.h"
 void testLoopPattern::operator()() {
     std::cout << "\n=== Test scenario 2: cyclic scanning test ===" << std::endl;
 
@@ -17,52 +23,65 @@ void testLoopPattern::operator()() {
     KArcCache::KLruCache<int, std::string> lru(CAPACITY);
     KArcCache::KLfuCache<int, std::string> lfu(CAPACITY,2);
     KArcCache::ArcCache<int, std::string> arc(CAPACITY,25);
+    // 同样的 ARC，开启扫描检测：顺序段的新键插到 LRU 尾部，不再冲掉随机段留下的工作集
+    KArcCache::ArcCache<int, std::string> arcScan(CAPACITY, 25);
+    arcScan.enableScanDetection();
+    KArcCache::KLirsCache<int, std::string> lirs(CAPACITY);
+    KArcCache::KS3FifoCache<int, std::string> s3fifo(CAPACITY);
+    KArcCache::KSlruCache<int, std::string> slru(CAPACITY);
+    KArcCache::K2QCache<int, std::string> twoQ(CAPACITY);
+    KArcCache::KMetaCache<int, std::string> meta(CAPACITY, KArcCache::KMetaCache<int, std::string>::defaultCandidates(2, 25));
 
-    std::array<KArcCache::KICachePolicy<int, std::string>*, 3> caches = { &lru, &lfu, &arc };
-    std::vector<int> hits(3, 0);
-    std::vector<int> get_operations(3, 0);
-    std::vector<std::string> names = { "LRU", "LFU", "ARC" };
+    // 先生成完整的操作序列与值，计时循环里只剩缓存操作本身；三种算法回放同一序列
+    KArcCache::workload::Rng rng(123456);
+    KArcCache::workload::Ops<int> ops;
+    ops.reserve(OPERATIONS);
+    int current_pos = 0;
+    for (int op = 0; op < OPERATIONS; ++op) {
+        // 真正 20% 写
+        bool isPut = rng.percent(20);
+        int key;
 
-    for (int i = 0; i < caches.size(); ++i) {
-        // 每轮固定种子，确保三算法看到同一随机序列
-        std::mt19937 gen(123456);
+        int m = op % 100;
+        if (m < 60) {                  // 60% 顺序
+            key = current_pos;
+            current_pos = (current_pos + 1) % LOOP_SIZE;
+        }
+        else if (m < 90) {           // 30% 随机
+            key = int(rng.below(LOOP_SIZE));
+        }
+        else {                        // 10% 越界，只读
+            key = LOOP_SIZE + int(rng.below(LOOP_SIZE));
+        }
+
+        // 禁止越界写入，避免污染
+        if (key >= LOOP_SIZE) isPut = false;
+        ops.push_back(KArcCache::workload::makeOp<int>(key, isPut));
+    }
+    const std::vector<std::string> values = KArcCache::workload::makeValues(LOOP_SIZE, "loop");
+
+    std::vector<KArcCache::KICachePolicy<int, std::string>*> caches = { &lru, &lfu, &arc, &arcScan, &lirs, &s3fifo, &slru, &twoQ, &meta };
+    std::vector<int> hits(caches.size(), 0);
+    std::vector<int> get_operations(caches.size(), 0);
+    std::vector<std::string> names = { "LRU", "LFU", "ARC", "ARC-scan", "LIRS", "S3-FIFO", "SLRU", "2Q", "Meta" };
 
+    for (int i = 0; i < caches.size(); ++i) {
         // 预热不超过容量，且不计入统计
         for (int k = 0; k < std::min(CAPACITY, LOOP_SIZE); ++k) {
             caches[i]->put(k, "warm");
         }
 
-        int current_pos = 0;
         int discard_gets = 2 * CAPACITY;   // 丢弃前 2C 次 get
         int seen_gets = 0;
 
-        for (int op = 0; op < OPERATIONS; ++op) {
-            // CHANGE 3: 真正 20% 写
-            bool isPut = (gen() % 100 < 20);
-            int key;
-
-            int m = op % 100;
-            if (m < 60) {                  // 60% 顺序
-                key = current_pos;
-                current_pos = (current_pos + 1) % LOOP_SIZE;
-            }
-            else if (m < 90) {           // 30% 随机
-                key = int(gen() % LOOP_SIZE);
-            }
-            else {                        // 10% 越界，只读
-                key = LOOP_SIZE + int(gen() % LOOP_SIZE);
-            }
-
-            // 禁止越界写入，避免污染
-            if (key >= LOOP_SIZE) isPut = false;
-
-            if (isPut) {
-                std::string value = "loop" + std::to_string(key) + "_v" + std::to_string(op % 100);
-                caches[i]->put(key, value);
+        auto begin = std::chrono::steady_clock::now();
+        for (const auto& op : ops) {
+            if (op.type == KArcCache::TraceOpType::Put) {
+                caches[i]->put(op.key, values[op.key]);
             }
             else {
                 std::string result;
-                bool hit = caches[i]->get(key, result);
+                bool hit = caches[i]->get(op.key, result);
                 //丢弃冷启动 get，不计入统计
                 if (seen_gets >= discard_gets) {
                     get_operations[i]++;
@@ -73,7 +92,9 @@ void testLoopPattern::operator()() {
                 }
             }
         }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
 
-        printResults(names[i], CAPACITY, get_operations[i], hits[i]);
+        printResults(names[i], CAPACITY, get_operations[i], hits[i], elapsed);
     }
+    std::cout << "Meta ended on " << meta.activePolicy() << " after " << meta.switches() << " switches\n";
 }
@@ -0,0 +1,51 @@
+#include "testMemoryOverhead.h"
+#include "KArcCache.h"
+#include "KLirsCache.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include "LRU_K.h"
+#include "LFU.h"
+void testMemoryOverhead::operator()() {
+    std::cout << "\n=== Test scenario 5: per-entry memory overhead ===" << std::endl;
+
+    const int ENTRIES = 100000;
+
+    KArcCache::KLruCache<int, std::string> lru(ENTRIES);
+    KArcCache::KLruKCache<int, std::string> lruk(ENTRIES, ENTRIES, 2);
+    KArcCache::KLfuCache<int, std::string> lfu(ENTRIES, 10);
+    KArcCache::ArcCache<int, std::string> arc(ENTRIES, 2);
+    KArcCache::KLirsCache<int, std::string> lirs(ENTRIES);
+
+    std::vector<KArcCache::KICachePolicy<int, std::string>*> caches = { &lru, &lruk, &lfu, &arc, &lirs };
+    std::vector<std::string> names = { "LRU", "LRU-K", "LFU", "ARC", "LIRS" };
+
+    // 超出 SSO 的 std::string 才有额外堆内存
+    KArcCache::ValueSizer<std::string> stringHeap = [](const std::string& s) -> size_t {
+        return s.capacity() > 15 ? s.capacity() + 1 : 0;
+    };
+
+    for (size_t i = 0; i < caches.size(); ++i) {
+        // 写两遍让 LRU-K 晋升，再读一遍让 ARC 的两部分和幽灵缓存都进入稳态
+        for (int round = 0; round < 2; ++round) {
+            for (int key = 0; key < ENTRIES; ++key) {
+                caches[i]->put(key, "payload-" + std::to_string(key));
+            }
+        }
+        std::string value;
+        for (int key = 0; key < ENTRIES; ++key) {
+            caches[i]->get(key, value);
+        }
+
+        KArcCache::MemoryUsage usage = caches[i]->memoryUsage(stringHeap);
+        double perEntry = usage.entries ? 1.0 / usage.entries : 0.0;
+        std::cout << names[i] << " | entries=" << usage.entries
+            << " | bytes/entry=" << usage.total() * perEntry
+            << " | metadata/entry=" << usage.metadata() * perEntry
+            << " (index=" << usage.index * perEntry
+            << ", nodes=" << usage.nodes * perEntry
+            << ", ghost=" << usage.ghost * perEntry
+            << ", freq=" << usage.freqBuckets * perEntry
+            << ") | values/entry=" << usage.values * perEntry << "\n";
+    }
+}
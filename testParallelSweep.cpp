@@ -0,0 +1,62 @@
+#include "testParallelSweep.h"
+#include "printResults.h"
+#include "KArcCache.h"
+#include "KTraceSimulator.h"
+#include "KLirsCache.h"
+#include "KS3FifoCache.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "LRU_K.h"
+#include "LFU.h"
+void testParallelSweep::operator()() {
+    std::cout << "\n=== Test scenario 4: parallel capacity sweep ===" << std::endl;
+
+    const int LOOP_SIZE = 500;
+    const int OPERATIONS = 1000000;
+    const size_t CAPACITIES[] = { 25, 50, 100, 200, 400, 600 };
+
+    // 只生成一次：与循环扫描场景相同的访问模式，所有配置共享同一份只读序列
+    std::mt19937 gen(123456);
+    std::vector<KArcCache::TraceOp<int>> trace;
+    trace.reserve(OPERATIONS);
+    int current_pos = 0;
+    for (int op = 0; op < OPERATIONS; ++op) {
+        bool isPut = (gen() % 100 < 20);
+        int key;
+        int m = op % 100;
+        if (m < 60) {
+            key = current_pos;
+            current_pos = (current_pos + 1) % LOOP_SIZE;
+        }
+        else if (m < 90) {
+            key = int(gen() % LOOP_SIZE);
+        }
+        else {
+            key = LOOP_SIZE + int(gen() % LOOP_SIZE);
+        }
+        if (key >= LOOP_SIZE) isPut = false;
+        trace.push_back({ key, isPut ? KArcCache::TraceOpType::Put : KArcCache::TraceOpType::Get });
+    }
+
+    using Policy = KArcCache::KICachePolicy<int, std::string>;
+    KArcCache::TraceSimulator<int, std::string> simulator;
+    for (size_t cap : CAPACITIES) {
+        simulator.addConfig("LRU", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::KLruCache<int, std::string>(int(cap))); });
+        simulator.addConfig("LFU", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::KLfuCache<int, std::string>(int(cap), 2)); });
+        simulator.addConfig("ARC", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::ArcCache<int, std::string>(cap, 25)); });
+        simulator.addConfig("LIRS", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::KLirsCache<int, std::string>(cap)); });
+        simulator.addConfig("S3-FIFO", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::KS3FifoCache<int, std::string>(cap)); });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = simulator.run(trace);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    for (const auto& r : results) {
+        printResults(r.name, int(r.capacity), int(r.gets), int(r.hits));
+    }
+    std::cout << results.size() << " configurations in " << elapsed.count() << " ms\n";
+}
@@ -0,0 +1,63 @@
+#include "testPutLatency.h"
+#include "KArcCache.h"
+#include "KWorkload.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    // 逐个计时 put，打印延迟分位数与前台同步逐出次数。
+    // maintainEvery 非 0 时每隔这么多个请求由本线程调用一次 maintain()（不计入 put 的计时，计入总时间）
+    void runPuts(const std::string& name, KArcCache::ArcCache<int, std::string>& cache,
+        const KArcCache::workload::Ops<int>& ops, const std::vector<std::string>& values, size_t maintainEvery = 0) {
+        using Clock = std::chrono::steady_clock;
+        std::vector<double> latencies;
+        latencies.reserve(ops.size());
+        std::string value;
+        auto begin = Clock::now();
+        size_t requests = 0;
+        for (const auto& op : ops) {
+            if (maintainEvery && ++requests % maintainEvery == 0) cache.maintain();
+            if (op.type == KArcCache::TraceOpType::Get) {
+                cache.get(op.key, value);
+                continue;
+            }
+            auto start = Clock::now();
+            cache.put(op.key, values[op.key]);
+            latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+        std::sort(latencies.begin(), latencies.end());
+        auto pct = [&](double p) { return latencies.empty() ? 0.0 : latencies[size_t(p * (latencies.size() - 1))]; };
+        std::cout << name << " | puts=" << latencies.size()
+            << " | p50=" << pct(0.5) << "ns | p99=" << pct(0.99) << "ns | p99.9=" << pct(0.999) << "ns"
+            << " | foreground_evictions=" << cache.foregroundEvictions()
+            << " | time=" << elapsed << "ms\n";
+    }
+}
+
+void testPutLatency::operator()() {
+    std::cout << "\n=== Test scenario 9: put latency with background maintenance ===" << std::endl;
+
+    const int CAPACITY = 4096;
+    const int KEYS = 200000;
+    const int OPERATIONS = 400000;
+
+    // 50% 写、键空间远大于容量：大部分写入是新键，每次都要腾出空槽
+    const auto ops = KArcCache::workload::scrambledZipfian(OPERATIONS, KEYS, 0.8, 50, 91);
+    const auto values = KArcCache::workload::makeValues(KEYS, "value");
+
+    KArcCache::ArcCache<int, std::string> arc(CAPACITY, 2);
+    runPuts("ARC", arc, ops, values);
+
+    KArcCache::ArcCache<int, std::string> maintained(CAPACITY, 2);
+    maintained.enableMaintenance();
+    runPuts("ARC+maint", maintained, ops, values);
+
+    // 不开后台线程，由写入线程在请求之间自己维护：没有线程唤醒和切换
+    KArcCache::ArcCache<int, std::string> inlineMaintained(CAPACITY, 2);
+    inlineMaintained.enableMaintenance(0, false);
+    runPuts("ARC+maint(inline)", inlineMaintained, ops, values, 16);
+}
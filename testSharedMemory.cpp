@@ -0,0 +1,137 @@
+#include "testSharedMemory.h"
+#include "KArcCache.h"
+#include "KShmArcCache.h"
+#include "KWorkload.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // 每个工作者按自己的请求流做旁路缓存（未命中时回填），cacheFor(w) 给出工作者 w 使用的缓存，
+    // bytes() 在回放结束后统计全部缓存的内存占用
+    template<typename CacheFor, typename Bytes>
+    void runWorkers(const std::string& name, int workers, const KArcCache::workload::Ops<int>& ops,
+        CacheFor cacheFor, Bytes bytes) {
+        std::atomic<size_t> gets{ 0 }, hits{ 0 };
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (int w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w] {
+                auto& cache = cacheFor(w);
+                size_t localGets = 0, localHits = 0;
+                long value;
+                // 请求轮流分给各工作者，相当于负载均衡把同一个热点分布打到所有进程上
+                for (size_t i = w; i < ops.size(); i += workers) {
+                    const auto& op = ops[i];
+                    if (op.type == KArcCache::TraceOpType::Put) {
+                        cache.put(op.key, op.key);
+                        continue;
+                    }
+                    ++localGets;
+                    if (cache.get(op.key, value)) ++localHits;
+                    else cache.put(op.key, op.key);
+                }
+                gets += localGets;
+                hits += localHits;
+            });
+        }
+        for (auto& t : threads) t.join();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << " | workers=" << workers << " | hit_rate=" << (gets ? hits * 100.0 / gets : 0.0)
+            << "% | bytes=" << bytes() << " | Mops/s=" << ops.size() / ms / 1000.0 << "\n";
+    }
+
+#ifndef _WIN32
+    // 键比较在段锁内进行：置位后在比较中途退出进程，模拟进程更新共享段时崩溃
+    struct ExitWhileLocked {
+        static bool& armed() { static bool flag = false; return flag; }
+        bool operator()(int a, int b) const {
+            if (armed()) _exit(0);
+            return a == b;
+        }
+    };
+
+    // fork 出的子进程持锁时死掉，父进程下一次加锁应恢复一次（清空缓存），之后照常可用
+    void checkCrashRecovery() {
+        using Cache = KArcCache::ShmArcCache<int, long, std::hash<int>, ExitWhileLocked>;
+        Cache cache("", 64, 2); // 匿名段，子进程继承同一份映射
+        if (!cache.valid()) {
+            std::cout << "ShmARC crash recovery | shared memory unavailable\n";
+            return;
+        }
+        for (int k = 0; k < 32; ++k) cache.put(k, k);
+        std::cout.flush(); // 子进程不能带着未输出的缓冲退出
+        pid_t pid = fork();
+        if (pid == 0) {
+            ExitWhileLocked::armed() = true;
+            long value;
+            cache.get(1, value); // 在 LRU 部分的哈希链上比较键时退出，锁不会释放
+            _exit(1);
+        }
+        int status = 0;
+        bool childDied = pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+        long value = 0;
+        bool cleared = !cache.get(1, value); // 这次加锁发现持有者已死，清空缓存
+        cache.put(7, 70);
+        bool usable = cache.get(7, value) && value == 70 && cache.size() == 1;
+        uint64_t recoveries = cache.recoveries();
+        std::cout << "ShmARC crash recovery | child_died_holding_lock=" << childDied << " | recoveries=" << recoveries
+            << " | cleared=" << cleared << " | usable_after=" << usable
+            << " | ok=" << (childDied && recoveries == 1 && cleared && usable && cache.valid()) << "\n";
+    }
+#endif
+}
+
+void testSharedMemory::operator()() {
+    std::cout << "\n=== Test scenario 11: shared-memory ARC across workers ===" << std::endl;
+
+    const int WORKERS = 16;
+    const int CAPACITY = 16384; // 所有工作者的缓存条目总预算
+    const int KEYS = 200000;
+    const int OPERATIONS = 1600000;
+
+    const auto ops = KArcCache::workload::scrambledZipfian(OPERATIONS, KEYS, 0.9, 5, 111);
+
+    // 各工作者私有一个 ArcCache，预算均分：热点在每个工作者里各存一份
+    std::vector<std::unique_ptr<KArcCache::ArcCache<int, long>>> privateCaches;
+    for (int w = 0; w < WORKERS; ++w) {
+        privateCaches.push_back(std::make_unique<KArcCache::ArcCache<int, long>>(CAPACITY / WORKERS, 2));
+    }
+    runWorkers("ARC (private per worker)", WORKERS, ops,
+        [&](int w) -> KArcCache::ArcCache<int, long>& { return *privateCaches[w]; },
+        [&] {
+            size_t bytes = 0;
+            for (auto& c : privateCaches) bytes += c->memoryUsage().total();
+            return bytes;
+        });
+
+    // 各工作者各自按名字打开同一个共享内存段（映射地址互不相同），全部预算给一份缓存
+    const std::string name = "karc_scenario11";
+    using ShmCache = KArcCache::ShmArcCache<int, long>;
+    ShmCache::remove(name);
+    std::vector<std::unique_ptr<ShmCache>> handles;
+    for (int w = 0; w < WORKERS; ++w) handles.push_back(std::make_unique<ShmCache>(name, CAPACITY, 2));
+    if (!handles[0]->valid()) {
+        std::cout << "ShmArcCache | shared memory unavailable\n";
+        return;
+    }
+    runWorkers("ShmARC (shared)", WORKERS, ops,
+        [&](int w) -> ShmCache& { return *handles[w]; },
+        [&] { return handles[0]->memoryUsage().total(); });
+    std::cout << "ShmARC | recoveries=" << handles[0]->recoveries() << "\n";
+    handles.clear();
+    ShmCache::remove(name);
+
+#ifndef _WIN32
+    checkCrashRecovery();
+#endif
+}
@@ -0,0 +1,4 @@
+#pragma once
+struct testSharedMemory {
+	void operator()();
+};
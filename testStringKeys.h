@@ -0,0 +1,4 @@
+#pragma once
+struct testStringKeys {
+	void operator()();
+};
@@ -0,0 +1,57 @@
+#include "testTraceReplay.h"
+#include "printResults.h"
+#include "KArcCache.h"
+#include "KTraceReader.h"
+#include "KLirsCache.h"
+#include "KTraceSimulator.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "LRU_K.h"
+#include "LFU.h"
+void testTraceReplay::operator()() {
+    std::cout << "\n=== Test scenario 7: public trace format replay ===" << std::endl;
+
+    struct TraceFile {
+        const char* path;
+        KArcCache::TraceFormat format;
+    };
+    // 仓库自带的小样本，路径相对于工作目录（VS 默认是工程目录）
+    const TraceFile TRACES[] = {
+        { "traces/arc-sample.lis", KArcCache::TraceFormat::Arc },
+        { "traces/spc-sample.spc", KArcCache::TraceFormat::Spc },
+        { "traces/msr-sample.csv", KArcCache::TraceFormat::Msr },
+        { "traces/twitter-sample.csv", KArcCache::TraceFormat::Twitter },
+        { "traces/wiki-sample.tr", KArcCache::TraceFormat::Wikipedia },
+    };
+    const size_t CAPACITIES[] = { 64, 256, 1024 };
+    const size_t CHUNK = 1 << 12;
+
+    using Key = KArcCache::TraceReader::Key;
+    using Policy = KArcCache::KICachePolicy<Key, std::string>;
+    for (const auto& trace : TRACES) {
+        std::ifstream in(trace.path);
+        if (!in) {
+            std::cout << trace.path << " not found, skipped\n";
+            continue;
+        }
+
+        KArcCache::TraceSimulator<Key, std::string> simulator;
+        for (size_t cap : CAPACITIES) {
+            simulator.addConfig("LRU", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::KLruCache<Key, std::string>(int(cap))); });
+            simulator.addConfig("LFU", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::KLfuCache<Key, std::string>(int(cap), 2)); });
+            simulator.addConfig("ARC", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::ArcCache<Key, std::string>(cap, 2)); });
+            simulator.addConfig("LIRS", cap, [cap] { return std::unique_ptr<Policy>(new KArcCache::KLirsCache<Key, std::string>(cap)); });
+        }
+
+        // 解析与回放流式进行，trace 多大内存都只占几个块
+        KArcCache::TraceReader reader(in, trace.format);
+        auto results = simulator.run([&](std::vector<KArcCache::TraceOp<Key>>& chunk) { return reader.fill(chunk, CHUNK); });
+
+        std::cout << trace.path << " | lines=" << reader.lines() << " | skipped=" << reader.skipped() << "\n";
+        for (const auto& r : results) {
+            printResults(r.name, int(r.capacity), int(r.gets), int(r.hits));
+        }
+    }
+}
@@ -0,0 +1,4 @@
+#pragma once
+struct testTraceReplay {
+	void operator()();
+};
@@ -0,0 +1,73 @@
+#include "testWarmRestart.h"
+#include "KArcCache.h"
+#include "KWorkload.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double millisSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 旁路缓存：get 未命中时回填，写入直接 put；返回读命中率
+    double replay(KArcCache::ArcCache<int, std::string>& cache, const KArcCache::workload::Ops<int>& ops,
+        size_t begin, size_t end, const std::vector<std::string>& values) {
+        size_t gets = 0, hits = 0;
+        std::string value;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& op = ops[i];
+            if (op.type == KArcCache::TraceOpType::Put) {
+                cache.put(op.key, values[op.key]);
+                continue;
+            }
+            ++gets;
+            if (cache.get(op.key, value)) ++hits;
+            else cache.put(op.key, values[op.key]);
+        }
+        return gets ? hits * 100.0 / gets : 0.0;
+    }
+}
+
+void testWarmRestart::operator()() {
+    std::cout << "\n=== Test scenario 10: snapshot and warm restart ===" << std::endl;
+
+    const int CAPACITY = 50000;
+    const int KEYS = 500000;
+    const size_t WARMUP = 400000;
+    const size_t MEASURE = 100000;
+    const char* PATH = "arc-snapshot.bin";
+
+    const auto ops = KArcCache::workload::scrambledZipfian(WARMUP + MEASURE, KEYS, 0.9, 5, 101);
+    const auto values = KArcCache::workload::makeValues(KEYS, "value");
+
+    KArcCache::ArcCache<int, std::string> original(CAPACITY, 2);
+    replay(original, ops, 0, WARMUP, values);
+
+    auto start = Clock::now();
+    bool saved = original.snapshot(PATH);
+    double snapshotMs = millisSince(start);
+    std::ifstream file(PATH, std::ios::binary | std::ios::ate);
+    long long bytes = file ? static_cast<long long>(file.tellg()) : 0;
+    file.close();
+
+    KArcCache::ArcCache<int, std::string> restored(CAPACITY, 2);
+    start = Clock::now();
+    bool loaded = saved && restored.restore(PATH);
+    double restoreMs = millisSince(start);
+    std::remove(PATH);
+    std::cout << "snapshot | ok=" << saved << " | bytes=" << bytes << " | time=" << snapshotMs << "ms\n";
+    std::cout << "restore | ok=" << loaded << " | entries=" << restored.memoryUsage().entries
+        << " | time=" << restoreMs << "ms\n";
+
+    // 接下来的请求分别交给：未重启的实例、从快照恢复的实例、空实例
+    KArcCache::ArcCache<int, std::string> cold(CAPACITY, 2);
+    std::cout << "ARC (no restart) | hit_rate=" << replay(original, ops, WARMUP, WARMUP + MEASURE, values) << "%\n";
+    std::cout << "ARC (restored) | hit_rate=" << replay(restored, ops, WARMUP, WARMUP + MEASURE, values) << "%\n";
+    std::cout << "ARC (cold) | hit_rate=" << replay(cold, ops, WARMUP, WARMUP + MEASURE, values) << "%\n";
+}
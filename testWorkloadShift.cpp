@@ -3,10 +3,15 @@
 #include "KArcCache.h"
 #include <iostream>
 #include <string>
-#include <array>
-#include <random>
+#include <vector>
+#include <chrono>
 #include "LRU_K.h"
 #include "LFU.h"
+#include "KWorkload.h"
+#include "KLirsCache.h"
+#include "KSlruCache.h"
+#include "K2QCache.h"
+#include "KMetaCache.h"
 void testWorkloadShift::operator()() {
     std::cout << "\n=== Test scenario 3: Workload drastic changes test ===" << std::endl;
 
@@ -16,92 +21,88 @@ void testWorkloadShift::operator()() {
     KArcCache::KLruCache<int, std::string> lru(CAPACITY);
     KArcCache::KLfuCache<int, std::string> lfu(CAPACITY, 2);
     KArcCache::ArcCache<int, std::string> arc(CAPACITY, 25);
+    arc.enableAutoTuning(); // 影子缓存自动调参，跟随各阶段的负载变化
+    KArcCache::KLirsCache<int, std::string> lirs(CAPACITY);
+    KArcCache::KSlruCache<int, std::string> slru(CAPACITY);
+    KArcCache::K2QCache<int, std::string> twoQ(CAPACITY);
+    KArcCache::KMetaCache<int, std::string> meta(CAPACITY, KArcCache::KMetaCache<int, std::string>::defaultCandidates(2, 25));
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // 先按阶段生成完整的操作序列（固定种子），三种算法回放完全相同的请求流，计时只覆盖缓存操作
+    namespace wl = KArcCache::workload;
+    wl::Rng rng(20240607);
 
-    std::array<KArcCache::KICachePolicy<int, std::string>*, 3> caches = { &lru, &lfu, &arc };
-    std::vector<int> hits(3, 0);
-    std::vector<int> get_operations(3, 0);
-    std::vector<std::string> names = { "LRU", "LFU", "ARC" };
+    // 阶段4: 局部性随机 - 5个局部区域，每个区域15个键，与缓存大小接近但略小
+    // 每 800 次操作切换一个区域：先在 0–14 随机，再在 15–29 随机 ... 再回到 0–14
+    wl::Ops<int> local;
+    local.reserve(PHASE_LENGTH);
+    for (int op = PHASE_LENGTH * 3; op < PHASE_LENGTH * 4; ++op) {
+        bool isPut = rng.percent(25);
+        int locality = (op / 800) % 5;
+        local.push_back(wl::makeOp<int>(locality * 15 + rng.below(15), isPut));
+    }
 
-    // 为每种缓存算法运行相同的测试
-    for (int i = 0; i < caches.size(); ++i) {
-        // 先预热缓存，只插入少量初始数据
-        for (int key = 0; key < 30; key++)
-        {
-            std::string value = "init" + std::to_string(key); caches[i]->put(key, value);
-        }
+    // 阶段5: 混合访问 - 40% 热点（5个键）、30% 中等范围（45个键）、30% 大范围（350个键）
+    wl::Ops<int> mixed;
+    mixed.reserve(PHASE_LENGTH);
+    for (int op = 0; op < PHASE_LENGTH; ++op) {
+        bool isPut = rng.percent(20);
+        int r = int(rng.below(100));
+        int key;
+        if (r < 40) key = int(rng.below(5));
+        else if (r < 70) key = 5 + int(rng.below(45));
+        else key = 50 + int(rng.below(350));
+        mixed.push_back(wl::makeOp<int>(key, isPut));
+    }
 
-        for (int op = 0; op < OPERATIONS; op++)
-        {
-            int phase = op / PHASE_LENGTH; 
-            
+    const wl::Ops<int> ops = wl::phaseShift<int>({
+        wl::uniform(PHASE_LENGTH, 5, 15, 1),    // 阶段1: 热点访问，只在 0~4 五个热点上访问，15%写入
+        wl::uniform(PHASE_LENGTH, 400, 30, 2),  // 阶段2: 大范围随机，0~399，工作集远大于缓存，30%写入
+        wl::looping(PHASE_LENGTH, 100, 10, 3),  // 阶段3: 顺序扫描 0~99，10%写入
+        local,
+        mixed,
+    });
 
-            int putProbability;
-            switch (phase) {
-            case 0:putProbability = 15; break;  // 阶段1: 热点访问，15%写入更合理
-            case 1: putProbability = 30; break;  // 阶段2: 大范围随机，降低写比例为30%
-            case 2: putProbability = 10; break;  // 阶段3: 顺序扫描，10%写入保持不变
-            case 3: putProbability = 25; break;  // 阶段4: 局部性随机，微调为25%
-            case 4: putProbability = 20; break;  // 阶段5: 混合访问，调整为20%
-            default: putProbability = 20;
-            }
+    // 值按 (阶段, 键) 预先格式化
+    const int KEY_SPACE = 400;
+    std::vector<std::vector<std::string>> values(5);
+    for (int phase = 0; phase < 5; ++phase) {
+        values[phase].reserve(KEY_SPACE);
+        for (int key = 0; key < KEY_SPACE; ++key) {
+            values[phase].push_back("value" + std::to_string(key) + "_p" + std::to_string(phase));
+        }
+    }
+    const std::vector<std::string> initValues = wl::makeValues(30, "init");
 
-            // 确定是读还是写操作
-            bool isPut = (gen() % 100 < putProbability);
-            
-            //“op < 16000*2”，也就是“op < 32000”。
-            //所以在 0~31999 这段里，phase 是 0 或 1。
-            int key;
-            if (op < PHASE_LENGTH) {// 阶段1: 热点访问 - 减少热点数量从10到5，使热点更集中
-                key = gen() % 5;//只在 0~4 五个热点上循环访问
-            }
-            else if (op < PHASE_LENGTH * 2) { // 阶段2: 大范围随机 - 范围从1000减小到400，更适合20大小的缓存
-                key = gen() % 400;//在 0~399 间随机访问，工作集很大
-            }
-            else if (op < PHASE_LENGTH * 3) {  // 阶段3: 顺序扫描 - 保持100个键
-                key = (op - PHASE_LENGTH * 2) % 100; //从 0~99 顺序访问（扫描型）
-            }
-            else if (op < PHASE_LENGTH * 4) {  // 阶段4: 局部性随机 - 优化局部性区域大小
-                // 产生5个局部区域，每个区域大小为15个键，与缓存大小20接近但略小
-                int locality = (op / 800) % 5;  // 调整为5个局部区域
-                key = locality * 15 + (gen() % 15);  // 每区域15个键
-                //先 800 次在 0–14 随机
-                //再 800 次在 15–29 随机
-                //再 800 次在 30–44 随机
-                //...
-                // 再回到 0–14
+    std::vector<KArcCache::KICachePolicy<int, std::string>*> caches = { &lru, &lfu, &arc, &lirs, &slru, &twoQ, &meta };
+    std::vector<int> hits(caches.size(), 0);
+    std::vector<int> get_operations(caches.size(), 0);
+    std::vector<std::string> names = { "LRU", "LFU", "ARC", "LIRS", "SLRU", "2Q", "Meta" };
 
-            }
-            else {  // 阶段5: 混合访问 - 增加热点访问比例
-                int r = gen() % 100;
-                if (r < 40) {  // 40%概率访问热点（从30%增加）
-                    key = gen() % 5;  // 5个热点键
-                }
-                else if (r < 70) {  // 30%概率访问中等范围
-                    key = 5 + (gen() % 45);  // 缩小中等范围为50个键
-                }
-                else {  // 30%概率访问大范围（从40%减少）
-                    key = 50 + (gen() % 350);  // 大范围也相应缩小
-                }
-            }
+    // 为每种缓存算法运行相同的测试
+    for (int i = 0; i < caches.size(); ++i) {
+        // 先预热缓存，只插入少量初始数据
+        for (int key = 0; key < 30; key++) {
+            caches[i]->put(key, initValues[key]);
+        }
 
-            if (isPut) {
-                // 执行写操作
-                std::string value = "value" + std::to_string(key) + "_p" + std::to_string(phase);
-                caches[i]->put(key, value);
+        auto begin = std::chrono::steady_clock::now();
+        for (int op = 0; op < OPERATIONS; op++) {
+            const auto& request = ops[op];
+            if (request.type == KArcCache::TraceOpType::Put) {
+                caches[i]->put(request.key, values[op / PHASE_LENGTH][request.key]);
             }
             else {
                 // 执行读操作并记录命中情况
                 std::string result;
                 get_operations[i]++;
-                if (caches[i]->get(key, result)) {
+                if (caches[i]->get(request.key, result)) {
                     hits[i]++;
                 }
             }
         }
-        printResults("Workload drastic change test", CAPACITY, get_operations[i], hits[i]);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        printResults(names[i], CAPACITY, get_operations[i], hits[i], elapsed);
     }
+    std::cout << "Meta ended on " << meta.activePolicy() << " after " << meta.switches() << " switches\n";
 
 }
\ No newline at end of file